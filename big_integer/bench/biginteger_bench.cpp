@@ -0,0 +1,462 @@
+/** (C) 2017 Ivan Semenenko */
+
+/*
+*  Time and memory per operation of BigInteger from a single block up to
+*  ten million decimal digits: addition, comparison, multiplication,
+*  division, parsing and printing. Build together with all the library
+*  sources from ../src, e.g.
+*
+*      g++ -std=c++17 -O2 -I../src biginteger_bench.cpp $SOURCES -pthread
+*
+*  and add -DBIG_INTEGER_BENCH_GMP -lgmp for a column with the same
+*  operations in GMP. Options:
+*
+*      --json              JSON instead of CSV
+*      --max-digits N      stop the sweep at N digits (default 10000000)
+*      --min-time MS       run every measurement at least MS milliseconds
+*
+*  Bytes are all those allocated per operation through the global
+*  operator new, aligned or not: the blocks of the results and of the
+*  temporaries from the default memory resource as well as the strings.
+*/
+
+#include "biginteger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef BIG_INTEGER_BENCH_GMP
+#include <gmp.h>
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+// bytes taken through the global operator new in all its forms: the
+// default memory resource asks for aligned blocks, the standard
+// containers for plain ones
+std::atomic< std::size_t > g_allocatedBytes{ 0 };
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    void*
+    allocateBytes( std::size_t _bytes, std::size_t _alignment ) noexcept
+    {
+        g_allocatedBytes.fetch_add( _bytes, std::memory_order_relaxed );
+
+        if( !_bytes )
+            _bytes = 1;
+
+        if( _alignment <= alignof( std::max_align_t ) )
+            return std::malloc( _bytes );
+
+        // aligned_alloc wants a multiple of the alignment
+        return std::aligned_alloc( _alignment, ( _bytes + _alignment - 1 ) / _alignment * _alignment );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void*
+    allocateOrThrow( std::size_t _bytes, std::size_t _alignment )
+    {
+        if( void* pointer = allocateBytes( _bytes, _alignment ) )
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+void* operator new( std::size_t _bytes )
+{
+    return allocateOrThrow( _bytes, alignof( std::max_align_t ) );
+}
+
+void* operator new[]( std::size_t _bytes )
+{
+    return allocateOrThrow( _bytes, alignof( std::max_align_t ) );
+}
+
+void* operator new( std::size_t _bytes, std::align_val_t _alignment )
+{
+    return allocateOrThrow( _bytes, std::size_t( _alignment ) );
+}
+
+void* operator new[]( std::size_t _bytes, std::align_val_t _alignment )
+{
+    return allocateOrThrow( _bytes, std::size_t( _alignment ) );
+}
+
+void* operator new( std::size_t _bytes, std::nothrow_t const& ) noexcept
+{
+    return allocateBytes( _bytes, alignof( std::max_align_t ) );
+}
+
+void* operator new[]( std::size_t _bytes, std::nothrow_t const& ) noexcept
+{
+    return allocateBytes( _bytes, alignof( std::max_align_t ) );
+}
+
+void* operator new( std::size_t _bytes, std::align_val_t _alignment, std::nothrow_t const& ) noexcept
+{
+    return allocateBytes( _bytes, std::size_t( _alignment ) );
+}
+
+void* operator new[]( std::size_t _bytes, std::align_val_t _alignment, std::nothrow_t const& ) noexcept
+{
+    return allocateBytes( _bytes, std::size_t( _alignment ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+// malloc and aligned_alloc memory alike goes back through free
+
+void operator delete( void* _pointer ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer ) noexcept { std::free( _pointer ); }
+
+void operator delete( void* _pointer, std::size_t ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer, std::size_t ) noexcept { std::free( _pointer ); }
+
+void operator delete( void* _pointer, std::align_val_t ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer, std::align_val_t ) noexcept { std::free( _pointer ); }
+
+void operator delete( void* _pointer, std::size_t, std::align_val_t ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer, std::size_t, std::align_val_t ) noexcept { std::free( _pointer ); }
+
+void operator delete( void* _pointer, std::nothrow_t const& ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer, std::nothrow_t const& ) noexcept { std::free( _pointer ); }
+
+void operator delete( void* _pointer, std::align_val_t, std::nothrow_t const& ) noexcept { std::free( _pointer ); }
+
+void operator delete[]( void* _pointer, std::align_val_t, std::nothrow_t const& ) noexcept { std::free( _pointer ); }
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = BigInteger::size_type;
+    using Clock = std::chrono::steady_clock;
+
+/*-----------------------------------------------------------------------------------*/
+
+    struct Measurement
+    {
+        double m_nanoseconds;
+
+        double m_bytes;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    struct Options
+    {
+        bool m_json = false;
+
+        size_type m_maxDigits = 10000000;
+
+        double m_minTime = 100;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    Options g_options;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // repeats _operation, doubling the count, until the runs take at least
+    // the minimum time; the last round gives the figures per operation
+    template< typename _Operation >
+    Measurement
+    measure( _Operation _operation )
+    {
+        _operation();
+
+        for( size_type repetitions = 1; ; repetitions *= 2 )
+        {
+            size_type bytes = g_allocatedBytes.load( std::memory_order_relaxed );
+            Clock::time_point start = Clock::now();
+
+            for( size_type count = 0; count < repetitions; ++count )
+                _operation();
+
+            double elapsed = std::chrono::duration< double, std::milli >( Clock::now() - start ).count();
+
+            if( elapsed >= g_options.m_minTime || repetitions >= ( size_type( 1 ) << 30 ) )
+                return Measurement{
+                        elapsed * 1e6 / repetitions
+                    ,   double( g_allocatedBytes.load( std::memory_order_relaxed ) - bytes ) / repetitions
+                };
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    std::string
+    randomDigits( std::mt19937_64 & _generator, size_type _digits )
+    {
+        std::uniform_int_distribution< int > digit( 0, 9 );
+        std::string result( _digits, '0' );
+
+        for( char & character : result )
+            character = char( '0' + digit( _generator ) );
+
+        result[0] = char( '1' + digit( _generator ) % 9 );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    printHeader()
+    {
+        if( g_options.m_json )
+        {
+            std::printf( "[\n" );
+            return;
+        }
+
+        std::printf( "operation,digits,blocks,ns_per_op,bytes_per_op" );
+
+#ifdef BIG_INTEGER_BENCH_GMP
+        std::printf( ",gmp_ns_per_op" );
+#endif
+
+        std::printf( "\n" );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    printRow(
+            char const* _operation
+        ,   size_type _digits
+        ,   size_type _blocks
+        ,   Measurement _measurement
+        ,   [[maybe_unused]] double _gmpNanoseconds
+    )
+    {
+        static bool first = true;
+
+        if( !g_options.m_json )
+        {
+            std::printf(
+                    "%s,%zu,%zu,%.1f,%.0f"
+                ,   _operation
+                ,   _digits
+                ,   _blocks
+                ,   _measurement.m_nanoseconds
+                ,   _measurement.m_bytes
+            );
+
+#ifdef BIG_INTEGER_BENCH_GMP
+            std::printf( ",%.1f", _gmpNanoseconds );
+#endif
+
+            std::printf( "\n" );
+            std::fflush( stdout );
+            return;
+        }
+
+        std::printf(
+                "%s  {\"operation\": \"%s\", \"digits\": %zu, \"blocks\": %zu"
+                ", \"ns_per_op\": %.1f, \"bytes_per_op\": %.0f"
+            ,   first ? "" : ",\n"
+            ,   _operation
+            ,   _digits
+            ,   _blocks
+            ,   _measurement.m_nanoseconds
+            ,   _measurement.m_bytes
+        );
+
+#ifdef BIG_INTEGER_BENCH_GMP
+        std::printf( ", \"gmp_ns_per_op\": %.1f", _gmpNanoseconds );
+#endif
+
+        std::printf( "}" );
+        std::fflush( stdout );
+
+        first = false;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    printFooter()
+    {
+        if( g_options.m_json )
+            std::printf( "\n]\n" );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // every operation on operands of _digits digits; the dividend and the
+    // product have twice as many
+    void
+    sweep( std::mt19937_64 & _generator, size_type _digits )
+    {
+        std::string const leftDigits = randomDigits( _generator, _digits );
+        std::string const rightDigits = randomDigits( _generator, _digits );
+        std::string const dividendDigits = randomDigits( _generator, 2 * _digits );
+
+        BigInteger const left( leftDigits );
+        BigInteger const right( rightDigits );
+        BigInteger const dividend( dividendDigits );
+
+        // equal but for the lowest block, so that the comparison sees
+        // every block
+        BigInteger const nearlyLeft = left + size_type( 1 );
+
+        BigInteger result;
+        volatile bool sink = false;
+
+        size_type const blocks = left.getBlocksCount();
+
+        double gmp[6] = {};
+
+#ifdef BIG_INTEGER_BENCH_GMP
+        {
+            mpz_t gmpLeft, gmpRight, gmpDividend, gmpNearlyLeft, gmpResult;
+
+            mpz_init_set_str( gmpLeft, leftDigits.c_str(), 10 );
+            mpz_init_set_str( gmpRight, rightDigits.c_str(), 10 );
+            mpz_init_set_str( gmpDividend, dividendDigits.c_str(), 10 );
+            mpz_init( gmpNearlyLeft );
+            mpz_add_ui( gmpNearlyLeft, gmpLeft, 1 );
+            mpz_init( gmpResult );
+
+            std::vector< char > buffer( 2 * _digits + 2 );
+
+            gmp[0] = measure( [&]{ mpz_add( gmpResult, gmpLeft, gmpRight ); } ).m_nanoseconds;
+            gmp[1] = measure( [&]{ sink = mpz_cmp( gmpLeft, gmpNearlyLeft ) < 0; } ).m_nanoseconds;
+            gmp[2] = measure( [&]{ mpz_mul( gmpResult, gmpLeft, gmpRight ); } ).m_nanoseconds;
+            gmp[3] = measure( [&]{ mpz_tdiv_q( gmpResult, gmpDividend, gmpLeft ); } ).m_nanoseconds;
+            gmp[4] = measure( [&]{ mpz_set_str( gmpResult, leftDigits.c_str(), 10 ); } ).m_nanoseconds;
+            gmp[5] = measure( [&]{ mpz_get_str( buffer.data(), 10, gmpLeft ); } ).m_nanoseconds;
+
+            mpz_clear( gmpLeft );
+            mpz_clear( gmpRight );
+            mpz_clear( gmpDividend );
+            mpz_clear( gmpNearlyLeft );
+            mpz_clear( gmpResult );
+        }
+#endif
+
+        // printed into a stream that keeps its buffer, as GMP prints into
+        // a preallocated one
+        std::ostringstream stream;
+
+        printRow( "add", _digits, blocks, measure( [&]{ result = left + right; } ), gmp[0] );
+        printRow( "compare", _digits, blocks, measure( [&]{ sink = left < nearlyLeft; } ), gmp[1] );
+        printRow( "multiply", _digits, blocks, measure( [&]{ result = left * right; } ), gmp[2] );
+        printRow( "divide", _digits, blocks, measure( [&]{ result = dividend / left; } ), gmp[3] );
+        printRow( "parse", _digits, blocks, measure( [&]{ result = BigInteger( leftDigits ); } ), gmp[4] );
+
+        printRow(
+                "print"
+            ,   _digits
+            ,   blocks
+            ,   measure(
+                    [&]
+                    {
+                        stream.seekp( 0 );
+                        stream << left;
+                        sink = stream.tellp() > 0;
+                    }
+                )
+            ,   gmp[5]
+        );
+
+        static_cast< void >( sink );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    bool
+    parseOptions( int _argc, char** _argv )
+    {
+        for( int index = 1; index < _argc; ++index )
+        {
+            if( !std::strcmp( _argv[index], "--json" ) )
+                g_options.m_json = true;
+            else if( !std::strcmp( _argv[index], "--max-digits" ) && index + 1 < _argc )
+                g_options.m_maxDigits = std::strtoull( _argv[++index], nullptr, 10 );
+            else if( !std::strcmp( _argv[index], "--min-time" ) && index + 1 < _argc )
+                g_options.m_minTime = std::strtod( _argv[++index], nullptr );
+            else
+            {
+                std::fprintf(
+                        stderr
+                    ,   "usage: %s [--json] [--max-digits N] [--min-time MS]\n"
+                    ,   _argv[0]
+                );
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+int
+main( int _argc, char** _argv )
+{
+    if( !parseOptions( _argc, _argv ) )
+        return 1;
+
+    std::mt19937_64 generator( 1 );
+
+    printHeader();
+
+    // a single block, then one and three times the powers of ten
+    for( size_type digits : {
+                size_type( 19 )
+            ,   size_type( 100 ), size_type( 300 )
+            ,   size_type( 1000 ), size_type( 3000 )
+            ,   size_type( 10000 ), size_type( 30000 )
+            ,   size_type( 100000 ), size_type( 300000 )
+            ,   size_type( 1000000 ), size_type( 3000000 )
+            ,   size_type( 10000000 )
+        }
+    )
+    {
+        if( digits > g_options.m_maxDigits )
+            break;
+
+        sweep( generator, digits );
+    }
+
+    printFooter();
+
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------------*/
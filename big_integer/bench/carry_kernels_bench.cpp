@@ -0,0 +1,113 @@
+/** (C) 2017 Ivan Semenenko */
+
+/*
+*  Throughput of the carry kernels available on this CPU, relative to the
+*  portable loops. Build together with the library sources, e.g.
+*
+*      g++ -std=c++17 -O2 -I../src carry_kernels_bench.cpp ../src/carry_kernels.cpp
+*/
+
+#include "carry_kernels.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using CarryKernels::block_type;
+    using CarryKernels::size_type;
+    using Clock = std::chrono::steady_clock;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // nanoseconds per block of the fastest of several runs
+    template< typename _Kernel >
+    double
+    measure( _Kernel _kernel, size_type _size )
+    {
+        size_type const repetitions = ( size_type( 1 ) << 24 ) / _size + 1;
+        double best = 0;
+
+        for( int run = 0; run < 5; ++run )
+        {
+            Clock::time_point start = Clock::now();
+
+            for( size_type count = 0; count < repetitions; ++count )
+                _kernel();
+
+            double elapsed = std::chrono::duration< double, std::nano >( Clock::now() - start ).count();
+            double perBlock = elapsed / ( repetitions * _size );
+
+            if( !run || perBlock < best )
+                best = perBlock;
+        }
+
+        return best;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+int
+main()
+{
+    std::mt19937_64 generator( 1 );
+    std::vector< CarryKernels::Implementation > const& implementations = CarryKernels::available();
+
+    std::printf( "selected: %s\n\n", CarryKernels::selected().m_name );
+    std::printf( "%-14s %8s %10s %10s %10s\n", "kernel", "blocks", "add", "subtract", "addmul" );
+
+    for( size_type size : { 16, 256, 4096, 65536 } )
+    {
+        std::vector< block_type > left( size );
+        std::vector< block_type > right( size );
+        std::vector< block_type > result( size );
+
+        for( size_type count = 0; count < size; ++count )
+        {
+            left[count] = generator();
+            right[count] = generator();
+        }
+
+        double baseline[3] = {};
+
+        for( CarryKernels::Implementation const& implementation : implementations )
+        {
+            volatile block_type sink = 0;
+
+            double timings[3] = {
+                    measure( [&]{ sink = sink + implementation.m_add( result.data(), left.data(), right.data(), size ); }, size )
+                ,   measure( [&]{ sink = sink + implementation.m_subtract( result.data(), left.data(), right.data(), size ); }, size )
+                ,   measure( [&]{ sink = sink + implementation.m_addMul( result.data(), left.data(), size, right[0] ); }, size )
+            };
+
+            if( &implementation == &implementations.front() )
+                std::copy( timings, timings + 3, baseline );
+
+            std::printf(
+                    "%-14s %8zu %6.3f ns %6.3f ns %6.3f ns   speedup %.2fx %.2fx %.2fx\n"
+                ,   implementation.m_name
+                ,   size
+                ,   timings[0]
+                ,   timings[1]
+                ,   timings[2]
+                ,   baseline[0] / timings[0]
+                ,   baseline[1] / timings[1]
+                ,   baseline[2] / timings[2]
+            );
+        }
+    }
+
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------------*/
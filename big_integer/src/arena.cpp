@@ -0,0 +1,186 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    // chunk headers keep the payload aligned for any fundamental type
+    constexpr std::size_t HeaderSize =
+        ( sizeof( void* ) + sizeof( std::size_t ) + alignof( std::max_align_t ) - 1 )
+            / alignof( std::max_align_t ) * alignof( std::max_align_t );
+
+/*-----------------------------------------------------------------------------------*/
+
+    char*
+    alignUp( char* _pointer, std::size_t _alignment ) noexcept
+    {
+        std::uintptr_t value = reinterpret_cast< std::uintptr_t >( _pointer );
+        std::uintptr_t aligned = ( value + _alignment - 1 ) & ~( _alignment - 1 );
+
+        return _pointer + ( aligned - value );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+Arena::Arena( size_type _chunkSize, std::pmr::memory_resource * _upstream )
+    :    m_upstream{ _upstream }
+    ,    m_chunks{ nullptr }
+    ,    m_current{ nullptr }
+    ,    m_end{ nullptr }
+    ,    m_nextChunkSize{ std::max( _chunkSize, HeaderSize + alignof( std::max_align_t ) ) }
+    ,    m_usedBytes{ 0 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Arena::~Arena()
+{
+    releaseChunks( m_chunks );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Arena::reset() noexcept
+{
+    m_usedBytes = 0;
+
+    if( !m_chunks )
+        return;
+
+    // keep the largest chunk, give the others back
+    Chunk* largest = m_chunks;
+    for( Chunk* chunk = m_chunks->m_next; chunk; chunk = chunk->m_next )
+        if( chunk->m_size > largest->m_size )
+            largest = chunk;
+
+    Chunk* others = nullptr;
+    for( Chunk* chunk = m_chunks; chunk; )
+    {
+        Chunk* next = chunk->m_next;
+
+        if( chunk != largest )
+        {
+            chunk->m_next = others;
+            others = chunk;
+        }
+
+        chunk = next;
+    }
+
+    releaseChunks( others );
+
+    largest->m_next = nullptr;
+    m_chunks = largest;
+
+    m_current = reinterpret_cast< char* >( largest ) + HeaderSize;
+    m_end = reinterpret_cast< char* >( largest ) + largest->m_size;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Arena::size_type
+Arena::getUsedBytes() const noexcept
+{
+    return m_usedBytes;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Arena::size_type
+Arena::getReservedBytes() const noexcept
+{
+    size_type bytes = 0;
+
+    for( Chunk* chunk = m_chunks; chunk; chunk = chunk->m_next )
+        bytes += chunk->m_size;
+
+    return bytes;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void*
+Arena::do_allocate( size_type _bytes, size_type _alignment )
+{
+    char* pointer = m_current ? alignUp( m_current, _alignment ) : nullptr;
+
+    if( !pointer || _bytes > size_type( m_end - pointer ) )
+    {
+        addChunk( HeaderSize + _bytes + _alignment );
+        pointer = alignUp( m_current, _alignment );
+    }
+
+    m_current = pointer + _bytes;
+    m_usedBytes += _bytes;
+
+    return pointer;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Arena::do_deallocate( void* _pointer, size_type _bytes, size_type )
+{
+    // only the newest block can be reused before a reset
+    if( static_cast< char* >( _pointer ) + _bytes == m_current )
+    {
+        m_current = static_cast< char* >( _pointer );
+        m_usedBytes -= _bytes;
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Arena::do_is_equal( std::pmr::memory_resource const& _other ) const noexcept
+{
+    return this == &_other;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Arena::addChunk( size_type _minimalSize )
+{
+    size_type size = std::max( m_nextChunkSize, _minimalSize );
+
+    void* memory = m_upstream->allocate( size, alignof( std::max_align_t ) );
+
+    Chunk* chunk = new( memory ) Chunk{ m_chunks, size };
+    m_chunks = chunk;
+
+    m_current = reinterpret_cast< char* >( chunk ) + HeaderSize;
+    m_end = reinterpret_cast< char* >( chunk ) + size;
+
+    m_nextChunkSize = 2 * m_nextChunkSize;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Arena::releaseChunks( Chunk* _chunk ) noexcept
+{
+    while( _chunk )
+    {
+        Chunk* next = _chunk->m_next;
+
+        m_upstream->deallocate( _chunk, _chunk->m_size, alignof( std::max_align_t ) );
+        _chunk = next;
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,116 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_ARENA_HPP_
+#define BIG_INTEGER_ARENA_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include <cstddef>
+#include <memory_resource>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Size in bytes of the first chunk an Arena takes from its upstream
+*  resource, later chunks double. Can be overridden from the compiler
+*  command line.
+*/
+
+#ifndef BIG_INTEGER_ARENA_CHUNK_SIZE
+#define BIG_INTEGER_ARENA_CHUNK_SIZE 65536
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Bump-pointer memory resource for short-lived values. Allocation moves a
+*  pointer through the current chunk, deallocation only gives back the
+*  most recent block, and reset() frees everything at once:
+*
+*      Arena arena;
+*      BigInteger x( "12345", &arena );
+*      ...
+*      arena.reset(); // every value using the arena must be gone by now
+*
+*  The largest chunk is kept across resets, so a steady workload ends up
+*  never calling the upstream resource. Not thread safe: use one arena per
+*  thread or request.
+*/
+
+class Arena
+    :   public std::pmr::memory_resource
+{
+    public:
+
+        using size_type = std::size_t;
+
+        static constexpr size_type ChunkSize = BIG_INTEGER_ARENA_CHUNK_SIZE;
+
+        /*---------------------------------------------------------------------------*/
+
+        explicit Arena(
+                size_type _chunkSize = ChunkSize
+            ,   std::pmr::memory_resource * _upstream = std::pmr::new_delete_resource()
+        );
+
+        Arena( Arena const& ) = delete;
+
+        Arena& operator = ( Arena const& ) = delete;
+
+        ~Arena() override;
+
+        /*---------------------------------------------------------------------------*/
+
+        // releases all the allocations at once
+        void reset() noexcept;
+
+        // bytes handed out since construction or the last reset
+        size_type getUsedBytes() const noexcept;
+
+        // bytes held from the upstream resource
+        size_type getReservedBytes() const noexcept;
+
+    private:
+
+        void* do_allocate( size_type _bytes, size_type _alignment ) override;
+
+        void do_deallocate( void* _pointer, size_type _bytes, size_type _alignment ) override;
+
+        bool do_is_equal( std::pmr::memory_resource const& _other ) const noexcept override;
+
+        /*---------------------------------------------------------------------------*/
+
+        // header at the start of every chunk, the newest chunk first
+        struct Chunk
+        {
+            Chunk* m_next;
+
+            size_type m_size;
+        };
+
+        void addChunk( size_type _minimalSize );
+
+        void releaseChunks( Chunk* _chunk ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        std::pmr::memory_resource* m_upstream;
+
+        Chunk* m_chunks;
+
+        // free space of the newest chunk
+        char* m_current;
+
+        char* m_end;
+
+        size_type m_nextChunkSize;
+
+        size_type m_usedBytes;
+
+}; // class Arena
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_ARENA_HPP_
+
+/*-----------------------------------------------------------------------------------*/
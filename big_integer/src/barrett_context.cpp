@@ -0,0 +1,174 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "barrett_context.hpp"
+#include "carry_kernels.hpp"
+#include "division.hpp"
+#include "modular_power.hpp"
+#include "multiplication.hpp"
+#include "messages.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+BarrettContext::BarrettContext( BigInteger const& _modulus )
+    :    m_modulus{ _modulus }
+    ,    m_modulusBlocks( _modulus.m_pData, _modulus.m_pData + _modulus.m_size )
+{
+    if( !_modulus.m_size )
+        throw std::logic_error( Messages::DivisionByZero );
+
+    size_type n = size();
+
+    Blocks power( 2 * n + 1, 0 );
+    power[2 * n] = 1;
+
+    Blocks remainder( n );
+    m_reciprocal.resize( n + 2 );
+
+    Division::divide(
+            m_reciprocal.data()
+        ,   remainder.data()
+        ,   power.data()
+        ,   power.size()
+        ,   m_modulusBlocks.data()
+        ,   n
+    );
+
+    m_reciprocal.resize( BlockArithmetic::normalizedSize( m_reciprocal.data(), n + 2 ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger const&
+BarrettContext::modulus() const noexcept
+{
+    return m_modulus;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+BarrettContext::multiply( BigInteger const& _left, BigInteger const& _right ) const
+{
+    Blocks scratch;
+    Blocks result;
+
+    multiply( result, residue( _left ), residue( _right ), scratch );
+
+    return BigInteger::fromBlocks( result.data(), result.size() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+BarrettContext::pow( BigInteger const& _base, BigInteger const& _exponent ) const
+{
+    Blocks result = ModularPower::power( *this, residue( _base ), _exponent );
+
+    return BigInteger::fromBlocks( result.data(), result.size() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BarrettContext::size_type
+BarrettContext::size() const noexcept
+{
+    return m_modulusBlocks.size();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BarrettContext::Blocks
+BarrettContext::one() const
+{
+    return residue( BigInteger( "1" ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BarrettContext::multiply(
+        Blocks & _result
+    ,   Blocks const& _left
+    ,   Blocks const& _right
+    ,   Blocks & _scratch
+) const
+{
+    size_type n = size();
+
+    _scratch.resize( scratchSize() );
+    Multiplication::multiply( _scratch.data(), _left.data(), n, _right.data(), n );
+
+    reduce( _result, _scratch );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BarrettContext::square( Blocks & _result, Blocks const& _value, Blocks & _scratch ) const
+{
+    size_type n = size();
+
+    _scratch.resize( scratchSize() );
+    Multiplication::square( _scratch.data(), _value.data(), n );
+
+    reduce( _result, _scratch );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BarrettContext::reduce( Blocks & _result, Blocks & _product ) const
+{
+    size_type n = size();
+    size_type reciprocalSize = m_reciprocal.size();
+
+    block_type* product = _product.data();
+    block_type* estimate = product + 2 * n;
+    block_type* multiple = estimate + n + 1 + reciprocalSize;
+
+    // q = floor( floor( x / B^( n - 1 ) ) * mu / B^( n + 1 ) ) undershoots
+    // x / m by at most two
+    Multiplication::multiply(
+            estimate
+        ,   product + n - 1
+        ,   n + 1
+        ,   m_reciprocal.data()
+        ,   reciprocalSize
+    );
+
+    Multiplication::multiply( multiple, estimate + n + 1, n + 1, m_modulusBlocks.data(), n );
+
+    // x - q * m only needs its lowest n + 1 blocks
+    CarryKernels::subBlocks( product, product, n + 1, multiple, n + 1 );
+
+    while( product[n] || BlockArithmetic::compareBlocks( product, m_modulusBlocks.data(), n ) >= 0 )
+        product[n] -= BlockArithmetic::subBlocks( product, product, n, m_modulusBlocks.data(), n );
+
+    _result.assign( product, product + n );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BarrettContext::size_type
+BarrettContext::scratchSize() const noexcept
+{
+    // product, estimate and multiple of the modulus
+    size_type n = size();
+
+    return 2 * n + ( n + 1 + m_reciprocal.size() ) + ( 2 * n + 1 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BarrettContext::Blocks
+BarrettContext::residue( BigInteger const& _value ) const
+{
+    BigInteger reduced = _value % m_modulus;
+
+    Blocks result( size(), 0 );
+    std::copy_n( reduced.m_pData, reduced.m_size, result.data() );
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,85 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_BARRETT_CONTEXT_HPP_
+#define BIG_INTEGER_BARRETT_CONTEXT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Arithmetic modulo a fixed non-zero modulus m of n blocks through Barrett
+*  reduction with the precomputed floor( 2^( 128 * n ) / m ). Slower than
+*  MontgomeryContext but not limited to odd moduli. Immutable after
+*  construction, like MontgomeryContext.
+*/
+
+class BarrettContext
+{
+    public:
+
+        using size_type = BigInteger::size_type;
+        using block_type = BigInteger::block_type;
+        using Blocks = std::vector< block_type >;
+
+        /*---------------------------------------------------------------------------*/
+
+        explicit BarrettContext( BigInteger const& _modulus );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger const& modulus() const noexcept;
+
+        // _left * _right mod modulus()
+        BigInteger multiply( BigInteger const& _left, BigInteger const& _right ) const;
+
+        // _base ^ _exponent mod modulus(), sliding-window exponentiation
+        BigInteger pow( BigInteger const& _base, BigInteger const& _exponent ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        // residues below the modulus, size() blocks each
+
+        size_type size() const noexcept;
+
+        Blocks one() const;
+
+        void multiply(
+                Blocks & _result
+            ,   Blocks const& _left
+            ,   Blocks const& _right
+            ,   Blocks & _scratch
+        ) const;
+
+        void square( Blocks & _result, Blocks const& _value, Blocks & _scratch ) const;
+
+    private:
+
+        // _result = _product mod m, _product holds 2n blocks in front of
+        // the scratch space
+        void reduce( Blocks & _result, Blocks & _product ) const;
+
+        size_type scratchSize() const noexcept;
+
+        Blocks residue( BigInteger const& _value ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger m_modulus;
+
+        Blocks m_modulusBlocks;
+
+        // floor( B^2n / m ), n + 1 or n + 2 blocks
+        Blocks m_reciprocal;
+
+}; // class BarrettContext
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_BARRETT_CONTEXT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -1,81 +1,181 @@
 /** (C) 2017 Ivan Semenenko */
 
 #include "biginteger.hpp"
+#include "block_arithmetic.hpp"
+#include "binary_format.hpp"
+#include "carry_kernels.hpp"
+#include "conversion.hpp"
+#include "division.hpp"
+#include "multiplication.hpp"
+#include "parallel.hpp"
+#include "power.hpp"
+#include "summation.hpp"
 #include "messages.hpp"
 
+#include <istream>
+#include <ostream>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger::BigInteger()
-    :    m_pData{ nullptr }
-    ,    m_size{ 0 }
+    :   BigInteger( std::pmr::get_default_resource() )
 {
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::BigInteger( std::string const& _str )
+BigInteger::BigInteger( std::pmr::memory_resource * _resource )
+    :    m_pData{ m_inline }
+    ,    m_size{ 0 }
+    ,    m_capacity{ InlineBlocks }
+    ,    m_resource{ _resource }
 {
-    checkNumberString( _str );
+}
 
-    m_size = _str.length();
-    m_pData = new block_type[m_size];
+/*-----------------------------------------------------------------------------------*/
 
+BigInteger::BigInteger( std::string_view _str, std::pmr::memory_resource * _resource )
+    :   BigInteger( _resource )
+{
+    checkNumberString( _str );
     fillArray( _str );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger::BigInteger( BigInteger const& _other )
-    :    m_size{ _other.m_size }
+    :   BigInteger()
 {
-    m_pData = new block_type[m_size];
+    *this = _other;
+}
 
-    std::memcpy(
-            m_pData
-        ,    _other.m_pData
-        ,    m_size * sizeof( block_type )
-    );
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::BigInteger( BigInteger const& _other, std::pmr::memory_resource * _resource )
+    :   BigInteger( _resource )
+{
+    *this = _other;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::BigInteger( BigInteger && _other )
-    :   m_pData{ nullptr }
-    ,   m_size{ _other.m_size }
+BigInteger::BigInteger( BigInteger && _other ) noexcept
+    :   BigInteger( _other.m_resource )
 {
-    std::swap( m_pData, _other.m_pData );
+    steal( _other );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger::~BigInteger()
 {
-    delete [] m_pData;
+    release();
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger::size_type
-BigInteger::getDigitsCount() const noexcept
+BigInteger::getDigitsCount() const
+{
+    if( !m_size )
+        return 1;
+
+    block_type top = m_pData[m_size - 1];
+    unsigned zeros = BlockArithmetic::countLeadingZeros( top );
+    size_type bits = m_size * BlockArithmetic::BlockBits - zeros;
+
+    // 2^( bits - 1 ) <= value < 2^bits, so that the value has either
+    // floor( ( bits - 1 ) log10 2 ) + 1 digits or, from 10^digits on,
+    // one more; floor( n log10 2 ) is n * floor( 2^64 log10 2 ) / 2^64
+    // with no error for any bit count a value can have
+    constexpr block_type Log10Of2 = 5553023288523357132ull;
+
+    block_type high;
+    BlockArithmetic::mulWide( bits - 1, Log10Of2, high );
+
+    size_type digits = size_type( high ) + 1;
+
+    // log2 of the value from its top 64 bits against log2 10^digits;
+    // a power of ten and its neighbours land within the margin, where
+    // only the exact comparison can tell
+    block_type leading = top << zeros;
+
+    if( zeros && m_size > 1 )
+        leading |= m_pData[m_size - 2] >> ( BlockArithmetic::BlockBits - zeros );
+
+    double log2Value = double( bits - 1 ) + std::log2( double( leading ) ) - ( BlockArithmetic::BlockBits - 1 );
+    double log2Power = double( digits ) * 3.321928094887362347870;
+    double margin = ( log2Power + BlockArithmetic::BlockBits ) * 1e-12;
+
+    if( log2Value < log2Power - margin )
+        return digits;
+
+    if( log2Value > log2Power + margin )
+        return digits + 1;
+
+    return digits + ( *this >= pow( BigInteger( "10" ), digits ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::size_type
+BigInteger::getBlocksCount() const noexcept
 {
     return m_size;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
+BigInteger::size_type
+BigInteger::getCapacity() const noexcept
+{
+    return m_capacity;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+std::pmr::memory_resource*
+BigInteger::getResource() const noexcept
+{
+    // borrowed values own no blocks and have no resource of their own
+    return m_resource ? m_resource : std::pmr::get_default_resource();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::reserve( size_type _capacity )
+{
+    if( _capacity > m_capacity )
+        reallocate( _capacity );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::shrink_to_fit()
+{
+    if( !isInline() && m_capacity > m_size )
+        reallocate( m_size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
 BigInteger&
 BigInteger::operator = ( BigInteger const& _other )
 {
-    delete [] m_pData;
+    if( this == &_other )
+        return *this;
 
-    m_size = _other.m_size;
-    m_pData = new block_type[m_size];
+    // the current buffer is reused when the value fits
+    if( _other.m_size > m_capacity )
+        allocate( _other.m_size );
 
-    std::memcpy(
-            m_pData
-        ,    _other.m_pData
-        ,    m_size * sizeof( char )
-    );
+    std::copy_n( _other.m_pData, _other.m_size, m_pData );
+    m_size = _other.m_size;
 
     return *this;
 }
@@ -85,104 +185,107 @@ BigInteger::operator = ( BigInteger const& _other )
 BigInteger&
 BigInteger::operator = ( BigInteger && _other )
 {
-    std::swap( m_size, _other.m_size );
-    std::swap( m_pData, _other.m_pData );
+    if( this == &_other )
+        return *this;
+
+    // blocks from another resource cannot be taken over
+    if( !sharesResource( _other ) )
+        return *this = static_cast< BigInteger const& >( _other );
+
+    release();
+    steal( _other );
 
     return *this;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-bool
-operator == ( BigInteger const& _left, BigInteger const& _right )
+int
+compare( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
+    // both sides are normalized, so that the longer one is the larger
     if( _left.m_size != _right.m_size )
-        return false;
+        return _left.m_size < _right.m_size ? -1 : 1;
 
-    for( BigInteger::size_type count = 0; count < _left.m_size; ++count )
-        if( _left.m_pData[count] != _right.m_pData[count] )
-            return false;
-
-    return true;
+    return BlockArithmetic::compareBlocks( _left.m_pData, _right.m_pData, _left.m_size );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-bool
-operator != ( BigInteger const& _left, BigInteger const& _right )
+#ifdef __cpp_impl_three_way_comparison
+
+std::strong_ordering
+operator <=> ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return !( _left == _right );
+    return compare( _left, _right ) <=> 0;
 }
 
+#endif
+
 /*-----------------------------------------------------------------------------------*/
 
 bool
-operator < ( BigInteger const& _left, BigInteger const& _right )
+operator == ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    if( _left.m_size < _right.m_size )
-        return true;
-    if( _left.m_size > _right.m_size )
-        return false;
-
-    for( int count = _left.m_size - 1; count >= 0; --count )
-        if( _left.m_pData[count] < _right.m_pData[count] )
-            return true;
-
-    return false;
+    return _left.m_size == _right.m_size
+        &&  std::equal( _left.m_pData, _left.m_pData + _left.m_size, _right.m_pData );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 bool
-operator > ( BigInteger const& _left, BigInteger const& _right )
+operator != ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return ( _left != _right ) && !( _left < _right );
+    return !( _left == _right );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 bool
-operator <= ( BigInteger const& _left, BigInteger const& _right )
+operator < ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return !( _left > _right );
+    return compare( _left, _right ) < 0;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 bool
-operator >= ( BigInteger const& _left, BigInteger const& _right )
+operator > ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return !( _left < _right );
+    return compare( _left, _right ) > 0;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::block_type
-BigInteger::operator [] ( size_type _position ) const
+bool
+operator <= ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return m_pData[_position + 1];
+    return compare( _left, _right ) <= 0;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::block_type&
-BigInteger::operator [] ( size_type _position )
+bool
+operator >= ( BigInteger const& _left, BigInteger const& _right ) noexcept
 {
-    return m_pData[_position + 1];
+    return compare( _left, _right ) >= 0;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::operator bool () const
+BigInteger::block_type
+BigInteger::getBlock( size_type _position ) const
 {
-    if( m_size == 0 )
-        return false;
+    checkRange( _position );
 
-    for( size_type count = 0; count < m_size; ++count )
-        if( m_pData[count] != '0' )
-            return true;
+    return m_pData[_position];
+}
 
-    return false;
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::operator bool () const noexcept
+{
+    return m_size != 0;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -194,12 +297,6 @@ operator >> ( std::istream & _stream, BigInteger & _bigInt )
     _stream >> inputString;
 
     _bigInt.checkNumberString( inputString );
-
-    delete [] _bigInt.m_pData;
-
-    _bigInt.m_size  = inputString.length();
-    _bigInt.m_pData = new BigInteger::block_type[_bigInt.m_size];
-
     _bigInt.fillArray( inputString );
 
     return _stream;
@@ -210,14 +307,82 @@ operator >> ( std::istream & _stream, BigInteger & _bigInt )
 std::ostream&
 operator << ( std::ostream & _stream, BigInteger const& _bigInt )
 {
-    std::string outputString;
+    _stream << _bigInt.toString();
 
-    for( int count = _bigInt.m_size - 1; count >= 0; --count )
-        outputString.push_back( _bigInt.m_pData[count] );
+    return _stream;
+}
 
-    _stream << outputString;
+/*-----------------------------------------------------------------------------------*/
 
-    return _stream;
+void
+BigInteger::writeBinary( std::ostream & _stream ) const
+{
+    block_type size = BinaryFormat::swapToLittle( m_size );
+    _stream.write( reinterpret_cast< char const* >( &size ), sizeof( size ) );
+
+    if( BinaryFormat::IsNative )
+    {
+        _stream.write( reinterpret_cast< char const* >( m_pData ), m_size * sizeof( block_type ) );
+        return;
+    }
+
+    for( size_type count = 0; count < m_size; ++count )
+    {
+        block_type block = BinaryFormat::swapToLittle( m_pData[count] );
+        _stream.write( reinterpret_cast< char const* >( &block ), sizeof( block ) );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+BigInteger::readBinary( std::istream & _stream )
+{
+    block_type size;
+    _stream.read( reinterpret_cast< char* >( &size ), sizeof( size ) );
+    checkData( _stream.gcount() == sizeof( size ) );
+
+    size = BinaryFormat::swapToLittle( size );
+
+    // no buffer could hold more, the count itself is corrupt
+    checkData( size <= std::numeric_limits< size_type >::max() / sizeof( block_type ) );
+
+    // the blocks are read a bounded piece at a time, so that a corrupt
+    // count runs out of data before it gets a huge allocation
+    constexpr size_type PieceBlocks = size_type( 1 ) << 16;
+
+    BigInteger result;
+
+    while( result.m_size < size )
+    {
+        size_type piece = std::min< size_type >( size - result.m_size, PieceBlocks );
+
+        result.reserve(
+            std::min< size_type >( size, std::max( 2 * result.m_capacity, result.m_size + piece ) )
+        );
+
+        block_type* array = result.m_pData + result.m_size;
+
+        _stream.read( reinterpret_cast< char* >( array ), piece * sizeof( block_type ) );
+        checkData( size_type( _stream.gcount() ) == piece * sizeof( block_type ) );
+
+        for( size_type count = 0; count < piece; ++count )
+            array[count] = BinaryFormat::swapToLittle( array[count] );
+
+        result.m_size += piece;
+    }
+
+    result.normalize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::size_type
+BigInteger::getBinarySize() const noexcept
+{
+    return BinaryFormat::recordSize( m_size );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -225,27 +390,44 @@ operator << ( std::ostream & _stream, BigInteger const& _bigInt )
 BigInteger&
 BigInteger::operator += ( BigInteger const& _other )
 {
-    size_type maxSize = std::max( m_size, _other.m_size );
-    block_type* array = new block_type[++maxSize]; 
+    block_type carry;
 
-    std::memset(
-            array
-        ,    0
-        ,    maxSize * sizeof( block_type )
-    );
-    
-    for( size_type count = 0; count < m_size; ++count )
-        array[count] += ( m_pData[count] - 48 );
-    
-    for( size_type count = 0; count < _other.m_size; ++count )
-        array[count] += ( _other.m_pData[count] - 48 );
+    if( m_size >= _other.m_size )
+    {
+        carry = CarryKernels::addBlocks(
+                m_pData
+            ,    m_pData
+            ,    _other.m_size
+            ,    _other.m_pData
+            ,    _other.m_size
+        );
+
+        carry = BlockArithmetic::incrementBlocks(
+                m_pData + _other.m_size
+            ,    m_size - _other.m_size
+            ,    carry
+        );
+    }
+    else
+    {
+        grow( _other.m_size + 1 );
 
-    carryDecision( array, maxSize );  
+        carry = CarryKernels::addBlocks(
+                m_pData
+            ,    _other.m_pData
+            ,    _other.m_size
+            ,    m_pData
+            ,    m_size
+        );
 
-    delete [] m_pData;
+        m_size = _other.m_size;
+    }
 
-    m_pData = array;
-    m_size  = maxSize;
+    if( carry )
+    {
+        grow( m_size + 1 );
+        m_pData[m_size++] = carry;
+    }
 
     return *this;
 }
@@ -255,33 +437,57 @@ BigInteger::operator += ( BigInteger const& _other )
 BigInteger&
 BigInteger::operator += ( size_type _integer )
 {
-    size_type intLength = getIntLength( _integer );
-    size_type maxSize = std::max( m_size, intLength );
-    block_type* array = new block_type[++maxSize];
+    block_type carry = BlockArithmetic::incrementBlocks( m_pData, m_size, _integer );
 
-    std::memset(
-        array
-        , 0
-        , maxSize * sizeof( block_type )
+    if( carry )
+    {
+        grow( m_size + 1 );
+        m_pData[m_size++] = carry;
+    }
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+operator + ( BigInteger _bigInt, BigInteger::size_type _integer )
+{
+    _bigInt += _integer;
+
+    return _bigInt;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator -= ( BigInteger const& _other )
+{
+    checkSubtrahend( _other <= *this );
+
+    CarryKernels::subBlocks(
+            m_pData
+        ,    m_pData
+        ,    m_size
+        ,    _other.m_pData
+        ,    _other.m_size
     );
-    
-    for( size_type count = 0; count < m_size; ++count )
-        array[count] += ( m_pData[count] - 48 );
-    
-    size_type index{ 0 };
-    for( 
-        size_type count = 10;
-        index < getIntLength( _integer );
-        count *= 10, ++index
-    )
-        array[index] += _integer % count;
 
-    carryDecision( array, maxSize );    
+    normalize();
 
-    delete[] m_pData;
+    return *this;
+}
 
-    m_pData = array;
-    m_size = maxSize;
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator -= ( size_type _integer )
+{
+    checkSubtrahend( m_size > 1 || ( m_size ? m_pData[0] : 0 ) >= _integer );
+
+    BlockArithmetic::decrementBlocks( m_pData, m_size, _integer );
+
+    normalize();
 
     return *this;
 }
@@ -289,67 +495,489 @@ BigInteger::operator += ( size_type _integer )
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger
-operator + ( BigInteger _left, BigInteger const& _right )
+operator - ( BigInteger _bigInt, BigInteger::size_type _integer )
+{
+    _bigInt -= _integer;
+
+    return _bigInt;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator *= ( BigInteger const& _other )
 {
-    return _left += _right;
+    assignProduct( *this, _other );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator *= ( size_type _integer )
+{
+    if( !m_size || !_integer )
+    {
+        m_size = 0;
+        return *this;
+    }
+
+    block_type high = BlockArithmetic::mulAddBlock(
+            m_pData
+        ,    m_pData
+        ,    m_size
+        ,    _integer
+        ,    0
+    );
+
+    if( high )
+    {
+        grow( m_size + 1 );
+        m_pData[m_size++] = high;
+    }
+
+    return *this;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 BigInteger
-operator + ( BigInteger _bigInt, BigInteger::size_type _integer )
+operator * ( BigInteger _bigInt, BigInteger::size_type _integer )
+{
+    _bigInt *= _integer;
+
+    return _bigInt;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator /= ( BigInteger const& _other )
+{
+    divide( *this, _other, this, nullptr );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator /= ( size_type _integer )
 {
-    return _bigInt += _integer;
+    checkDivisor( _integer != 0 );
+
+    BlockArithmetic::divBlock( m_pData, m_pData, m_size, _integer );
+
+    normalize();
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator %= ( BigInteger const& _other )
+{
+    divide( *this, _other, nullptr, this );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger&
+BigInteger::operator %= ( size_type _integer )
+{
+    checkDivisor( _integer != 0 );
+
+    if( m_size )
+    {
+        m_pData[0] = BlockArithmetic::modBlock( m_pData, m_size, _integer );
+        m_size = 1;
+
+        normalize();
+    }
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+operator / ( BigInteger _left, BigInteger const& _right )
+{
+    _left /= _right;
+
+    return _left;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+operator / ( BigInteger _bigInt, BigInteger::size_type _integer )
+{
+    _bigInt /= _integer;
+
+    return _bigInt;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+operator % ( BigInteger _left, BigInteger const& _right )
+{
+    _left %= _right;
+
+    return _left;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+operator % ( BigInteger _bigInt, BigInteger::size_type _integer )
+{
+    _bigInt %= _integer;
+
+    return _bigInt;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+std::pair< BigInteger, BigInteger >
+divmod( BigInteger const& _left, BigInteger const& _right )
+{
+    std::pair< BigInteger, BigInteger > result;
+
+    BigInteger::divide( _left, _right, &result.first, &result.second );
+
+    return result;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 void
-BigInteger::fillArray( std::string const& _string )
+BigInteger::divide(
+        BigInteger const& _left
+    ,   BigInteger const& _right
+    ,   BigInteger * _quotient
+    ,   BigInteger * _remainder
+)
 {
-    for( size_type count = 0; count < _string.length(); ++count )
-        m_pData[count] = _string[count];
+    _left.checkDivisor( static_cast< bool >( _right ) );
+
+    if( _left.m_size < _right.m_size )
+    {
+        if( _remainder && _remainder != &_left )
+            *_remainder = _left;
+
+        if( _quotient )
+            _quotient->m_size = 0;
+
+        return;
+    }
+
+    // the part not asked for is scratch and shares the resource of the other
+    std::pmr::memory_resource* resource = _quotient ? _quotient->m_resource : _remainder->m_resource;
+
+    BigInteger quotient( resource );
+    BigInteger remainder( _remainder ? _remainder->m_resource : resource );
+
+    Division::divide(
+            quotient.allocate( _left.m_size - _right.m_size + 1 )
+        ,    remainder.allocate( _right.m_size )
+        ,    _left.m_pData
+        ,    _left.m_size
+        ,    _right.m_pData
+        ,    _right.m_size
+        ,    resource
+    );
+
+    quotient.m_size = _left.m_size - _right.m_size + 1;
+    quotient.normalize();
+
+    remainder.m_size = _right.m_size;
+    remainder.normalize();
+
+    if( _quotient )
+        *_quotient = std::move( quotient );
+
+    if( _remainder )
+        *_remainder = std::move( remainder );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger::size_type
-BigInteger::getIntLength( size_type _number )
+BigInteger
+BigInteger::accumulate(
+        size_type _count
+    ,   size_type _parts
+    ,   std::pmr::memory_resource * _resource
+    ,   std::function< void( Summation::Accumulator &, size_type, size_type ) > const& _add
+)
 {
-    size_type resultLenght = 0;
+    if( !_parts )
+        _parts = Parallel::getThreads();
+
+    _parts = std::max< size_type >( std::min( _parts, _count / Parallel::getGrain() ), 1 );
+
+    // the parts may allocate from other threads of the pool at once
+    Parallel::SharedResource shared( _resource );
+
+    std::vector< Summation::Accumulator > accumulators;
+    accumulators.reserve( _parts );
+
+    for( size_type part = 0; part < _parts; ++part )
+        accumulators.emplace_back( shared.get() );
 
-    while( _number )
     {
-        _number /= 10;
-        ++resultLenght;
+        Parallel::TaskGroup group;
+
+        for( size_type part = 1; part < _parts; ++part )
+            group.run(
+                [&, part]
+                {
+                    _add( accumulators[part], _count * part / _parts, _count * ( part + 1 ) / _parts );
+                }
+            );
+
+        _add( accumulators[0], 0, _count / _parts );
+
+        group.wait();
     }
 
-    return resultLenght;
+    std::vector< BigInteger > partials;
+    partials.reserve( _parts );
+
+    for( Summation::Accumulator const& accumulator : accumulators )
+    {
+        BigInteger& partial = partials.emplace_back( _resource );
+        partial.m_size = accumulator.finish( partial.allocate( accumulator.resultSize() ) );
+    }
+
+    // pairwise reduction keeps the operands of every addition balanced
+    for( size_type step = 1; step < _parts; step *= 2 )
+        for( size_type index = 0; index + step < _parts; index += 2 * step )
+            partials[index] += partials[index + step];
+
+    return std::move( partials[0] );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::fillArray( std::string_view _string )
+{
+    block_type* array = allocate( Conversion::blocksForDigits( _string.length() ) );
+
+    m_size = Conversion::parseDecimal( array, _string.data(), _string.length(), m_resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+std::string
+BigInteger::toString() const
+{
+    return Conversion::toDecimal( m_pData, m_size, getResource() );
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 void
-BigInteger::carryDecision( block_type * _array, size_type _finish )
+BigInteger::normalize() noexcept
 {
-    for( size_type count = 0; count < _finish - 1; ++count )
+    m_size = BlockArithmetic::normalizedSize( m_pData, m_size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::assignProduct( BigInteger const& _left, BigInteger const& _right )
+{
+    if( !_left.m_size || !_right.m_size )
+    {
+        m_size = 0;
+        return;
+    }
+
+    // the product cannot be written over one of its factors
+    if( this == &_left || this == &_right )
     {
-        if( _array[count] > 9 )
-        {
-            _array[count] %= 10;
-            _array[count + 1] += 1;
-        }
+        BigInteger result( m_resource );
+        result.assignProduct( _left, _right );
 
-        _array[count] += 48;
+        *this = std::move( result );
+        return;
     }
 
-    _array[_finish - 1] += 48;
+    size_type size = _left.m_size + _right.m_size;
+    block_type* array = allocate( size );
+
+    if( &_left == &_right )
+        Multiplication::square( array, _left.m_pData, _left.m_size, m_resource );
+    else
+        Multiplication::multiply(
+                array
+            ,    _left.m_pData
+            ,    _left.m_size
+            ,    _right.m_pData
+            ,    _right.m_size
+            ,    m_resource
+        );
+
+    m_size = size;
+    normalize();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+BigInteger::fromBlocks( block_type const* _data, size_type _size )
+{
+    BigInteger result;
+
+    std::copy_n( _data, _size, result.allocate( _size ) );
+    result.m_size = _size;
+    result.normalize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::block_type*
+BigInteger::allocate( size_type _capacity )
+{
+    m_size = 0;
+
+    if( _capacity <= m_capacity )
+        return m_pData;
+
+    block_type* array = newBlocks( _capacity );
+
+    release();
+
+    m_pData = array;
+    m_capacity = _capacity;
+
+    return m_pData;
 }
 
 /*-----------------------------------------------------------------------------------*/
 
 void
-BigInteger::checkNumberString( std::string const& _string ) const
+BigInteger::release() noexcept
+{
+    if( !isInline() && !isBorrowed() )
+        deleteBlocks();
+
+    m_pData = m_inline;
+    m_size = 0;
+    m_capacity = InlineBlocks;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::reallocate( size_type _capacity )
+{
+    block_type* array = _capacity <= InlineBlocks
+        ?   m_inline
+        :   newBlocks( _capacity );
+
+    if( array == m_pData )
+        return;
+
+    std::copy_n( m_pData, m_size, array );
+
+    if( !isInline() )
+        deleteBlocks();
+
+    m_pData = array;
+    m_capacity = std::max( _capacity, InlineBlocks );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::grow( size_type _capacity )
+{
+    if( _capacity > m_capacity )
+        reallocate( std::max( _capacity, 2 * m_capacity ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::steal( BigInteger & _other ) noexcept
+{
+    // expects an empty inline object sharing the resource of _other,
+    // leaves _other as an empty inline one
+    m_resource = _other.m_resource;
+
+    if( _other.isInline() )
+        std::copy_n( _other.m_inline, _other.m_size, m_inline );
+    else
+    {
+        m_pData = _other.m_pData;
+        m_capacity = _other.m_capacity;
+
+        _other.m_pData = _other.m_inline;
+        _other.m_capacity = InlineBlocks;
+    }
+
+    m_size = _other.m_size;
+    _other.m_size = 0;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+BigInteger::isInline() const noexcept
+{
+    return m_pData == m_inline;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+BigInteger::isBorrowed() const noexcept
+{
+    return !m_capacity;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+BigInteger::sharesResource( BigInteger const& _other ) const noexcept
+{
+    // borrowed values have no resource
+    return m_resource == _other.m_resource
+        || ( m_resource && _other.m_resource && *m_resource == *_other.m_resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger::block_type*
+BigInteger::newBlocks( size_type _capacity )
+{
+    return static_cast< block_type* >(
+        m_resource->allocate( _capacity * sizeof( block_type ), alignof( block_type ) )
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::deleteBlocks() noexcept
+{
+    m_resource->deallocate( m_pData, m_capacity * sizeof( block_type ), alignof( block_type ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::checkNumberString( std::string_view _string ) const
 {
     for( size_type count = 0; count < _string.length(); ++count )
         checkDigit( _string[count] );
@@ -360,7 +988,7 @@ BigInteger::checkNumberString( std::string const& _string ) const
 void
 BigInteger::checkRange( size_type _position ) const
 {
-    if( _position > m_size )
+    if( _position >= m_size )
         throw std::logic_error( Messages::OutOfRange );
 }
 
@@ -375,13 +1003,39 @@ BigInteger::checkDigit( char _digit ) const
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger
-operator "" _b ( const char * _str )
+void
+BigInteger::checkDivisor( bool _isNonZero ) const
 {
-    std::string inputNumber( _str, std::strlen( _str ) );
-    BigInteger result( inputNumber );
+    if( !_isNonZero )
+        throw std::logic_error( Messages::DivisionByZero );
+}
 
-    return result;
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::checkSubtrahend( bool _isNotGreater ) const
+{
+    if( !_isNotGreater )
+        throw std::logic_error( Messages::NegativeResult );
 }
 
 /*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::checkSizes( bool _areEqual )
+{
+    if( !_areEqual )
+        throw std::logic_error( Messages::SizeMismatch );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigInteger::checkData( bool _isComplete )
+{
+    if( !_isComplete )
+        throw std::runtime_error( Messages::TruncatedData );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
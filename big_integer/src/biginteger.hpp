@@ -5,10 +5,55 @@
 
 /*-----------------------------------------------------------------------------------*/
 
+#include "summation.hpp"
+
 #include <stdexcept>
 #include <cstring>
+#include <cstdint>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <iosfwd>
+#include <memory_resource>
+#include <type_traits>
+
+#ifdef __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Number of blocks stored inside the object itself. Values that fit are
+*  never allocated on the heap. Can be overridden from the compiler command
+*  line.
+*/
+
+#ifndef BIG_INTEGER_INLINE_BLOCKS
+#define BIG_INTEGER_INLINE_BLOCKS 4
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Expression {
+
+    template< typename _Type >
+    struct IsExpression;
+
+    template< typename _Operation, typename _Left, typename _Right >
+    class Binary;
+
+}; // namespace Expression
+
+namespace Literal {
+
+    template< char... _Digits >
+    struct Constant;
+
+}; // namespace Literal
 
 /*-----------------------------------------------------------------------------------*/
 
@@ -17,51 +62,109 @@ class BigInteger
     public:
 
         using size_type = std::size_t;
-        using block_type = unsigned char;
+        using block_type = std::uint64_t;
 
         /*---------------------------------------------------------------------------*/
 
+        /*
+        *  Blocks that do not fit inline come from a memory resource, by
+        *  default std::pmr::get_default_resource() at construction time.
+        *  As with std::pmr containers, a copy gets the default resource
+        *  unless told otherwise, a moved-to object takes over the
+        *  resource of its source, and assignment keeps the resource of
+        *  the destination. Temporaries of an operation come from the
+        *  resource of its destination.
+        */
+
         BigInteger();
 
-        BigInteger( std::string const& _str );
+        explicit BigInteger( std::pmr::memory_resource * _resource );
+
+        BigInteger(
+                std::string_view _str
+            ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+        );
 
         BigInteger( BigInteger const& _other );
 
-        BigInteger( BigInteger && _other );
+        BigInteger( BigInteger const& _other, std::pmr::memory_resource * _resource );
+
+        BigInteger( BigInteger && _other ) noexcept;
+
+        // evaluates a lazy +, - or * expression, see expression.hpp
+        template<
+                typename _Expression
+            ,   typename = std::enable_if_t< Expression::IsExpression< _Expression >::value >
+        >
+        BigInteger( _Expression const& _expression );
 
         ~BigInteger();
 
         /*---------------------------------------------------------------------------*/
 
-        size_type getDigitsCount() const noexcept;
+        // decimal digits, 1 for zero; from the bit length, the value is
+        // compared with a power of ten only when it lies very close to one
+        size_type getDigitsCount() const;
+
+        size_type getBlocksCount() const noexcept;
+
+        size_type getCapacity() const noexcept;
+
+        // the default resource for a literal or an array view element
+        std::pmr::memory_resource* getResource() const noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        // room for at least _capacity blocks without reallocation
+        void reserve( size_type _capacity );
+
+        // drops the unused capacity, moving small values back inline
+        void shrink_to_fit();
 
         /*---------------------------------------------------------------------------*/
 
         BigInteger& operator = ( BigInteger const& _other );
 
+        // copies when the two resources differ
         BigInteger& operator = ( BigInteger && _other );
 
-        /*---------------------------------------------------------------------------*/
+        template<
+                typename _Expression
+            ,   typename = std::enable_if_t< Expression::IsExpression< _Expression >::value >
+        >
+        BigInteger& operator = ( _Expression const& _expression );
 
-        block_type operator [] ( size_type _position ) const;
+        /*---------------------------------------------------------------------------*/
 
-        block_type& operator [] ( size_type _position );
+        // base 2^64 block _position, least significant first, below
+        // getBlocksCount(); throws std::logic_error past the last one
+        block_type getBlock( size_type _position ) const;
 
-        operator bool() const;
+        explicit operator bool() const noexcept;
 
         /*---------------------------------------------------------------------------*/
 
-        friend bool operator < ( BigInteger const& _left, BigInteger const& _right );
+        // negative, zero or positive as _left is less than, equal to or
+        // greater than _right; the values are kept without leading zero
+        // blocks, so that the sizes decide first and the blocks are then
+        // compared a whole block at a time from the top
+        friend int compare( BigInteger const& _left, BigInteger const& _right ) noexcept;
+
+#ifdef __cpp_impl_three_way_comparison
+        friend std::strong_ordering operator <=> ( BigInteger const& _left, BigInteger const& _right ) noexcept;
+#endif
 
-        friend bool operator > ( BigInteger const& _left, BigInteger const& _right );
+        friend bool operator == ( BigInteger const& _left, BigInteger const& _right ) noexcept;
 
-        friend bool operator == ( BigInteger const& _left, BigInteger const& _right );
+        friend bool operator != ( BigInteger const& _left, BigInteger const& _right ) noexcept;
 
-        friend bool operator != ( BigInteger const& _left, BigInteger const& _right );
+        friend bool operator < ( BigInteger const& _left, BigInteger const& _right ) noexcept;
 
-        friend bool operator <= ( BigInteger const& _left, BigInteger const& _right );
+        friend bool operator > ( BigInteger const& _left, BigInteger const& _right ) noexcept;
 
-        friend bool operator >= ( BigInteger const& _left, BigInteger const& _right );
+        friend bool operator <= ( BigInteger const& _left, BigInteger const& _right ) noexcept;
+
+        friend bool operator >= ( BigInteger const& _left, BigInteger const& _right ) noexcept;
 
         friend std::istream& operator >> ( std::istream & _stream, BigInteger & _bigInt );
 
@@ -69,43 +172,282 @@ class BigInteger
 
         /*---------------------------------------------------------------------------*/
 
+        // little-endian blocks prefixed with their count, see binary_format.hpp
+        void writeBinary( std::ostream & _stream ) const;
+
+        // throws std::runtime_error on truncated or corrupt input
+        static BigInteger readBinary( std::istream & _stream );
+
+        size_type getBinarySize() const noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
         BigInteger& operator += ( BigInteger const& _other );
 
         BigInteger& operator += ( size_type _integer );
 
-        friend BigInteger operator + ( BigInteger _left, BigInteger const& _right );
-
         friend BigInteger operator + ( BigInteger _bigInt, size_type _integer );
 
+        /*---------------------------------------------------------------------------*/
+
+        // throw when the result would be negative
+        BigInteger& operator -= ( BigInteger const& _other );
+
+        BigInteger& operator -= ( size_type _integer );
+
+        friend BigInteger operator - ( BigInteger _bigInt, size_type _integer );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger& operator *= ( BigInteger const& _other );
+
+        BigInteger& operator *= ( size_type _integer );
+
+        friend BigInteger operator * ( BigInteger _bigInt, size_type _integer );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger& operator /= ( BigInteger const& _other );
+
+        BigInteger& operator /= ( size_type _integer );
+
+        BigInteger& operator %= ( BigInteger const& _other );
+
+        BigInteger& operator %= ( size_type _integer );
+
+        friend BigInteger operator / ( BigInteger _left, BigInteger const& _right );
+
+        friend BigInteger operator / ( BigInteger _bigInt, size_type _integer );
+
+        friend BigInteger operator % ( BigInteger _left, BigInteger const& _right );
+
+        friend BigInteger operator % ( BigInteger _bigInt, size_type _integer );
+
+        // quotient and remainder at the cost of a single division
+        friend std::pair< BigInteger, BigInteger > divmod(
+                BigInteger const& _left
+            ,   BigInteger const& _right
+        );
+
+        /*---------------------------------------------------------------------------*/
+
+        // sum of all the values in a range of BigInteger, much faster than
+        // a loop of +=: carries are propagated once at the end. With
+        // _threads other than 1 the range is split into that many parts,
+        // none shorter than Parallel::getGrain() values, summed as tasks
+        // of the Parallel pool; 0 stands for Parallel::getThreads(). The
+        // result and the scratch come from _resource
+        template< typename _Range >
+        static BigInteger sum(
+                _Range const& _values
+            ,   size_type _threads = 1
+            ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+        );
+
+        // sum of _values[i] * _weights[i], the ranges must be equally long
+        template< typename _Values, typename _Weights >
+        static BigInteger dot(
+                _Values const& _values
+            ,   _Weights const& _weights
+            ,   size_type _threads = 1
+            ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+        );
+
     private:
 
-        void fillArray( std::string const& _string );
+        static constexpr size_type InlineBlocks = BIG_INTEGER_INLINE_BLOCKS;
+
+        static_assert( InlineBlocks >= 1, "Inline buffer is too small" );
+
+        /*---------------------------------------------------------------------------*/
+
+        friend class FixedMultiplier;
+
+        friend class MontgomeryContext;
+
+        friend class BarrettContext;
+
+        friend class BigIntegerArrayView;
+
+        friend class Euclid;
+
+        friend class Powers;
+
+        template< typename _Operation, typename _Left, typename _Right >
+        friend class Expression::Binary;
+
+        template< char... _Digits >
+        friend struct Literal::Constant;
+
+        /*---------------------------------------------------------------------------*/
+
+        // a read-only value over blocks it does not own, see literal.hpp
+        constexpr BigInteger( block_type const* _data, size_type _size ) noexcept
+            :    m_pData{ const_cast< block_type* >( _data ) }
+            ,    m_size{ _size }
+            ,    m_capacity{ 0 }
+            ,    m_resource{ nullptr }
+            ,    m_inline{}
+        {}
+
+        /*---------------------------------------------------------------------------*/
+
+        void fillArray( std::string_view _string );
+
+        std::string toString() const;
+
+        void normalize() noexcept;
+
+        static BigInteger fromBlocks( block_type const* _data, size_type _size );
+
+        // *this = _left * _right, any of the three may be the same object
+        void assignProduct( BigInteger const& _left, BigInteger const& _right );
+
+        // storage for at least _capacity blocks, the old value is dropped
+        block_type* allocate( size_type _capacity );
+
+        void release() noexcept;
 
-        size_type getIntLength ( size_type _number );
+        // moves the value into storage of _capacity blocks, _capacity >= m_size
+        void reallocate( size_type _capacity );
 
-        void carryDecision( block_type * _array, size_type _finish );
+        // geometric growth to at least _capacity blocks, the value is kept
+        void grow( size_type _capacity );
+
+        void steal( BigInteger & _other ) noexcept;
+
+        bool isInline() const noexcept;
+
+        bool isBorrowed() const noexcept;
+
+        bool sharesResource( BigInteger const& _other ) const noexcept;
+
+        block_type* newBlocks( size_type _capacity );
+
+        // frees the heap array of m_capacity blocks m_pData points to
+        void deleteBlocks() noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        // splits [0, _count) into up to _parts parts summed by _add on the pool
+        static BigInteger accumulate(
+                size_type _count
+            ,   size_type _parts
+            ,   std::pmr::memory_resource * _resource
+            ,   std::function< void( Summation::Accumulator &, size_type, size_type ) > const& _add
+        );
 
         /*---------------------------------------------------------------------------*/
 
-        void checkNumberString( std::string const& _string ) const;
+        static void divide(
+                BigInteger const& _left
+            ,   BigInteger const& _right
+            ,   BigInteger * _quotient
+            ,   BigInteger * _remainder
+        );
+
+        /*---------------------------------------------------------------------------*/
+
+        void checkNumberString( std::string_view _string ) const;
 
         void checkRange( size_type _position ) const;
 
         void checkDigit( char _digit ) const;
 
+        void checkDivisor( bool _isNonZero ) const;
+
+        void checkSubtrahend( bool _isNotGreater ) const;
+
+        static void checkSizes( bool _areEqual );
+
+        static void checkData( bool _isComplete );
+
         /*---------------------------------------------------------------------------*/
 
+        // base 2^64 blocks, least significant first, no leading zero blocks;
+        // points either to m_inline or to a heap array of m_capacity blocks
         block_type* m_pData;
 
         size_type m_size;
 
+        // 0 for borrowed static blocks
+        size_type m_capacity;
+
+        std::pmr::memory_resource* m_resource;
+
+        block_type m_inline[InlineBlocks];
+
         /*---------------------------------------------------------------------------*/
 
 }; // class BigInteger
 
 /*-----------------------------------------------------------------------------------*/
 
-BigInteger operator "" _b ( const char * _str );
+template< typename _Range >
+BigInteger
+BigInteger::sum( _Range const& _values, size_type _threads, std::pmr::memory_resource * _resource )
+{
+    auto values = std::begin( _values );
+    size_type count = std::distance( values, std::end( _values ) );
+
+    return accumulate(
+            count
+        ,   _threads
+        ,   _resource
+        ,   [ values ]( Summation::Accumulator & _accumulator, size_type _begin, size_type _end )
+            {
+                auto value = std::next( values, _begin );
+
+                for( size_type index = _begin; index < _end; ++index, ++value )
+                {
+                    BigInteger const& term = *value;
+                    _accumulator.add( term.m_pData, term.m_size );
+                }
+            }
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Values, typename _Weights >
+BigInteger
+BigInteger::dot(
+        _Values const& _values
+    ,   _Weights const& _weights
+    ,   size_type _threads
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    auto values = std::begin( _values );
+    auto weights = std::begin( _weights );
+
+    size_type count = std::distance( values, std::end( _values ) );
+    checkSizes( count == size_type( std::distance( weights, std::end( _weights ) ) ) );
+
+    return accumulate(
+            count
+        ,   _threads
+        ,   _resource
+        ,   [ values, weights ]( Summation::Accumulator & _accumulator, size_type _begin, size_type _end )
+            {
+                auto value = std::next( values, _begin );
+                auto weight = std::next( weights, _begin );
+
+                for( size_type index = _begin; index < _end; ++index, ++value, ++weight )
+                {
+                    BigInteger const& left = *value;
+                    BigInteger const& right = *weight;
+
+                    _accumulator.addProduct( left.m_pData, left.m_size, right.m_pData, right.m_size );
+                }
+            }
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "expression.hpp"
+#include "literal.hpp"
 
 /*-----------------------------------------------------------------------------------*/
 
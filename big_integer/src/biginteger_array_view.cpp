@@ -0,0 +1,238 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "biginteger_array_view.hpp"
+#include "binary_format.hpp"
+#include "messages.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#define BIG_INTEGER_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::BigIntegerArrayView( std::string const& _path )
+    :   m_mapping{ nullptr }
+    ,   m_mappingSize{ 0 }
+{
+#ifdef BIG_INTEGER_HAS_MMAP
+
+    int file = ::open( _path.c_str(), O_RDONLY );
+    if( file < 0 )
+        throw std::system_error( errno, std::generic_category(), _path );
+
+    struct stat status;
+    if( ::fstat( file, &status ) )
+    {
+        int error = errno;
+        ::close( file );
+        throw std::system_error( error, std::generic_category(), _path );
+    }
+
+    size_type bytes = status.st_size;
+
+    if( bytes )
+    {
+        void* mapping = ::mmap( nullptr, bytes, PROT_READ, MAP_PRIVATE, file, 0 );
+        int error = errno;
+        ::close( file );
+
+        if( mapping == MAP_FAILED )
+            throw std::system_error( error, std::generic_category(), _path );
+
+        m_mapping = mapping;
+        m_mappingSize = bytes;
+    }
+    else
+        ::close( file );
+
+    try
+    {
+        if( BinaryFormat::IsNative )
+            index( static_cast< block_type const* >( m_mapping ), m_mappingSize );
+        else
+            convert( m_mapping, m_mappingSize );
+    }
+    catch( ... )
+    {
+        unmap();
+        throw;
+    }
+
+#else
+
+    std::ifstream stream( _path, std::ios::binary );
+    if( !stream )
+        throw std::system_error( std::make_error_code( std::errc::no_such_file_or_directory ), _path );
+
+    std::vector< char > bytes{ std::istreambuf_iterator< char >( stream ), std::istreambuf_iterator< char >() };
+    convert( bytes.data(), bytes.size() );
+
+#endif
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::BigIntegerArrayView( void const* _data, size_type _bytes )
+    :   m_mapping{ nullptr }
+    ,   m_mappingSize{ 0 }
+{
+    if( reinterpret_cast< std::uintptr_t >( _data ) % sizeof( block_type ) )
+        throw std::logic_error( Messages::MisalignedData );
+
+    if( BinaryFormat::IsNative )
+        index( static_cast< block_type const* >( _data ), _bytes );
+    else
+        convert( _data, _bytes );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::BigIntegerArrayView( BigIntegerArrayView && _other ) noexcept
+    :   m_mapping{ _other.m_mapping }
+    ,   m_mappingSize{ _other.m_mappingSize }
+    ,   m_converted( std::move( _other.m_converted ) )
+    ,   m_values( std::move( _other.m_values ) )
+{
+    _other.m_mapping = nullptr;
+    _other.m_mappingSize = 0;
+    _other.m_values.clear();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView&
+BigIntegerArrayView::operator = ( BigIntegerArrayView && _other ) noexcept
+{
+    if( this == &_other )
+        return *this;
+
+    unmap();
+
+    m_mapping = _other.m_mapping;
+    m_mappingSize = _other.m_mappingSize;
+    m_converted = std::move( _other.m_converted );
+    m_values = std::move( _other.m_values );
+
+    _other.m_mapping = nullptr;
+    _other.m_mappingSize = 0;
+    _other.m_values.clear();
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::~BigIntegerArrayView()
+{
+    unmap();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::size_type
+BigIntegerArrayView::size() const noexcept
+{
+    return m_values.size();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+BigIntegerArrayView::empty() const noexcept
+{
+    return m_values.empty();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger const&
+BigIntegerArrayView::operator [] ( size_type _index ) const
+{
+    if( _index >= m_values.size() )
+        throw std::out_of_range( Messages::OutOfRange );
+
+    return m_values[_index];
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::const_iterator
+BigIntegerArrayView::begin() const noexcept
+{
+    return m_values.begin();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigIntegerArrayView::const_iterator
+BigIntegerArrayView::end() const noexcept
+{
+    return m_values.end();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigIntegerArrayView::index( block_type const* _data, size_type _bytes )
+{
+    size_type words = _bytes / sizeof( block_type );
+    BigInteger::checkData( words * sizeof( block_type ) == _bytes );
+
+    for( size_type position = 0; position < words; )
+    {
+        size_type size = _data[position++];
+        BigInteger::checkData( size <= words - position );
+
+        block_type const* blocks = _data + position;
+        m_values.push_back( BigInteger( blocks, BlockArithmetic::normalizedSize( blocks, size ) ) );
+
+        position += size;
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigIntegerArrayView::convert( void const* _data, size_type _bytes )
+{
+    m_converted.resize( _bytes / sizeof( block_type ) );
+    std::copy_n(
+            static_cast< char const* >( _data )
+        ,   m_converted.size() * sizeof( block_type )
+        ,   reinterpret_cast< char* >( m_converted.data() )
+    );
+
+    for( block_type& word : m_converted )
+        word = BinaryFormat::swapToLittle( word );
+
+    // the partial word at the end, if any, is reported by index()
+    index( m_converted.data(), _bytes );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BigIntegerArrayView::unmap() noexcept
+{
+    m_values.clear();
+
+#ifdef BIG_INTEGER_HAS_MMAP
+    if( m_mapping )
+        ::munmap( m_mapping, m_mappingSize );
+#endif
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+}
+
+/*-----------------------------------------------------------------------------------*/
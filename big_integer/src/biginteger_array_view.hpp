@@ -0,0 +1,90 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_ARRAY_VIEW_HPP_
+#define BIG_INTEGER_ARRAY_VIEW_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+#include <string>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Read-only access to BigInteger records written one after another by
+*  BigInteger::writeBinary(). A file is memory-mapped and its values are
+*  exposed as BigInteger objects reading the mapped blocks directly, so
+*  opening costs one pass over the record headers and nothing is parsed or
+*  copied. The values stay valid as long as the view. On big-endian hosts
+*  and where mapping is not available the data is read into memory once.
+*/
+
+class BigIntegerArrayView
+{
+    public:
+
+        using size_type = BigInteger::size_type;
+        using block_type = BigInteger::block_type;
+        using const_iterator = std::vector< BigInteger >::const_iterator;
+
+        /*---------------------------------------------------------------------------*/
+
+        // throws std::system_error when the file cannot be mapped and
+        // std::runtime_error when its last record is incomplete
+        explicit BigIntegerArrayView( std::string const& _path );
+
+        // records in memory owned by the caller, which must be 8-byte
+        // aligned and outlive the view
+        BigIntegerArrayView( void const* _data, size_type _bytes );
+
+        BigIntegerArrayView( BigIntegerArrayView && _other ) noexcept;
+
+        BigIntegerArrayView( BigIntegerArrayView const& ) = delete;
+
+        BigIntegerArrayView& operator = ( BigIntegerArrayView && _other ) noexcept;
+
+        BigIntegerArrayView& operator = ( BigIntegerArrayView const& ) = delete;
+
+        ~BigIntegerArrayView();
+
+        /*---------------------------------------------------------------------------*/
+
+        size_type size() const noexcept;
+
+        bool empty() const noexcept;
+
+        BigInteger const& operator [] ( size_type _index ) const;
+
+        const_iterator begin() const noexcept;
+
+        const_iterator end() const noexcept;
+
+    private:
+
+        // builds m_values over _bytes of records already in host order
+        void index( block_type const* _data, size_type _bytes );
+
+        // copies the records in host order into m_converted and indexes them
+        void convert( void const* _data, size_type _bytes );
+
+        void unmap() noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        void* m_mapping;
+
+        size_type m_mappingSize;
+
+        std::vector< block_type > m_converted;
+
+        std::vector< BigInteger > m_values;
+
+}; // class BigIntegerArrayView
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_ARRAY_VIEW_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,64 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_BINARY_FORMAT_HPP_
+#define BIG_INTEGER_BINARY_FORMAT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Binary form of a BigInteger: the number of blocks and then the blocks,
+*  lowest first, every one a 64-bit little-endian word. Records are a
+*  multiple of 8 bytes, so the blocks of records stored back to back in an
+*  8-byte aligned buffer can be used in place on little-endian machines.
+*/
+
+namespace BinaryFormat {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool IsNative = false;
+#else
+    constexpr bool IsNative = true;
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+    // converts between the host and the little-endian order, both ways
+    constexpr block_type
+    swapToLittle( block_type _word ) noexcept
+    {
+        if( IsNative )
+            return _word;
+
+        block_type result = 0;
+        for( int count = 0; count < 8; ++count, _word >>= 8 )
+            result = result << 8 | ( _word & 0xFF );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    constexpr size_type
+    recordSize( size_type _blocks ) noexcept
+    {
+        return ( _blocks + 1 ) * sizeof( block_type );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace BinaryFormat
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_BINARY_FORMAT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
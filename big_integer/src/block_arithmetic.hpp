@@ -0,0 +1,514 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_BLOCK_ARITHMETIC_HPP_
+#define BIG_INTEGER_BLOCK_ARITHMETIC_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Primitive operations on arrays of 64-bit blocks stored least significant
+*  block first. None of these functions allocate or normalize, callers are
+*  responsible for providing big enough destination arrays.
+*/
+
+namespace BlockArithmetic {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using block_type = std::uint64_t;
+    using size_type  = std::size_t;
+
+    constexpr unsigned BlockBits = 64;
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline block_type
+    mulWide( block_type _left, block_type _right, block_type & _high ) noexcept
+    {
+#if defined( _MSC_VER )
+        return _umul128( _left, _right, &_high );
+#else
+        unsigned __int128 product = static_cast< unsigned __int128 >( _left ) * _right;
+        _high = static_cast< block_type >( product >> BlockBits );
+        return static_cast< block_type >( product );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // ( _high:_low ) / _divisor, requires _high < _divisor
+    inline block_type
+    divWide(
+            block_type _high
+        ,   block_type _low
+        ,   block_type _divisor
+        ,   block_type & _remainder
+    ) noexcept
+    {
+#if defined( _MSC_VER )
+        return _udiv128( _high, _low, _divisor, &_remainder );
+#else
+        unsigned __int128 dividend =
+                ( static_cast< unsigned __int128 >( _high ) << BlockBits )
+            |   _low
+        ;
+        _remainder = static_cast< block_type >( dividend % _divisor );
+        return static_cast< block_type >( dividend / _divisor );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _value must not be zero
+    inline unsigned
+    countLeadingZeros( block_type _value ) noexcept
+    {
+#if defined( _MSC_VER )
+        unsigned long index;
+        _BitScanReverse64( &index, _value );
+        return static_cast< unsigned >( BlockBits - 1 - index );
+#else
+        return static_cast< unsigned >( __builtin_clzll( _value ) );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // floor( ( 2^128 - 1 ) / _divisor ) - 2^64 for a divisor with the top bit set
+    inline block_type
+    reciprocal( block_type _divisor ) noexcept
+    {
+        block_type remainder;
+        return divWide( ~_divisor, ~block_type( 0 ), _divisor, remainder );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // ( _high:_low ) / _divisor with a precomputed reciprocal of the divisor,
+    // requires _high < _divisor and the top bit of the divisor set
+    // (Moller and Granlund, "Improved division by invariant integers")
+    inline block_type
+    divWide(
+            block_type _high
+        ,   block_type _low
+        ,   block_type _divisor
+        ,   block_type _reciprocal
+        ,   block_type & _remainder
+    ) noexcept
+    {
+        block_type quotientHigh;
+        block_type quotientLow = mulWide( _reciprocal, _high, quotientHigh );
+
+        quotientLow += _low;
+        quotientHigh += _high + 1 + ( quotientLow < _low );
+
+        _remainder = _low - quotientHigh * _divisor;
+
+        if( _remainder > quotientLow )
+        {
+            --quotientHigh;
+            _remainder += _divisor;
+        }
+
+        if( _remainder >= _divisor )
+        {
+            ++quotientHigh;
+            _remainder -= _divisor;
+        }
+
+        return quotientHigh;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left << _shift, 0 <= _shift < 64, returns the bits shifted out
+    inline block_type
+    shiftLeft(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _size
+        ,   unsigned _shift
+    ) noexcept
+    {
+        block_type carry = 0;
+
+        if( !_shift )
+        {
+            for( size_type count = 0; count < _size; ++count )
+                _result[count] = _left[count];
+
+            return carry;
+        }
+
+        for( size_type count = 0; count < _size; ++count )
+        {
+            block_type value = _left[count];
+            _result[count] = ( value << _shift ) | carry;
+            carry = value >> ( BlockBits - _shift );
+        }
+
+        return carry;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left >> _shift, 0 <= _shift < 64
+    inline void
+    shiftRight(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _size
+        ,   unsigned _shift
+    ) noexcept
+    {
+        if( !_shift )
+        {
+            for( size_type count = 0; count < _size; ++count )
+                _result[count] = _left[count];
+
+            return;
+        }
+
+        for( size_type count = 0; count < _size; ++count )
+        {
+            block_type high = count + 1 < _size ? _left[count + 1] << ( BlockBits - _shift ) : 0;
+            _result[count] = ( _left[count] >> _shift ) | high;
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left + _right, _leftSize >= _rightSize, returns carry out
+    inline block_type
+    addBlocks(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+    ) noexcept
+    {
+        block_type carry = 0;
+        size_type count = 0;
+
+        for( ; count < _rightSize; ++count )
+        {
+            block_type sum = _left[count] + carry;
+            carry = sum < carry;
+            sum += _right[count];
+            carry += sum < _right[count];
+            _result[count] = sum;
+        }
+
+        for( ; count < _leftSize; ++count )
+        {
+            _result[count] = _left[count] + carry;
+            carry = _result[count] < carry;
+        }
+
+        return carry;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left + _value, returns carry out
+    inline block_type
+    addBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _value
+    ) noexcept
+    {
+        for( size_type count = 0; count < _leftSize; ++count )
+        {
+            _result[count] = _left[count] + _value;
+            _value = _result[count] < _value;
+        }
+
+        return _value;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _data += _value in place, stops as soon as the carry dies out,
+    // returns carry out
+    inline block_type
+    incrementBlocks( block_type * _data, size_type _size, block_type _value ) noexcept
+    {
+        for( size_type count = 0; _value && count < _size; ++count )
+        {
+            _data[count] += _value;
+            _value = _data[count] < _value;
+        }
+
+        return _value;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left - _right, _leftSize >= _rightSize, returns borrow out
+    inline block_type
+    subBlocks(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+    ) noexcept
+    {
+        block_type borrow = 0;
+        size_type count = 0;
+
+        for( ; count < _rightSize; ++count )
+        {
+            block_type difference = _left[count] - _right[count];
+            block_type nextBorrow = _left[count] < _right[count];
+            nextBorrow += difference < borrow;
+            _result[count] = difference - borrow;
+            borrow = nextBorrow;
+        }
+
+        for( ; count < _leftSize; ++count )
+        {
+            block_type value = _left[count];
+            _result[count] = value - borrow;
+            borrow = value < borrow;
+        }
+
+        return borrow;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left - _value, returns borrow out
+    inline block_type
+    subBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _value
+    ) noexcept
+    {
+        for( size_type count = 0; count < _leftSize; ++count )
+        {
+            block_type value = _left[count];
+            _result[count] = value - _value;
+            _value = value < _value;
+        }
+
+        return _value;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _data -= _value in place, stops as soon as the borrow dies out,
+    // returns borrow out
+    inline block_type
+    decrementBlocks( block_type * _data, size_type _size, block_type _value ) noexcept
+    {
+        for( size_type count = 0; _value && count < _size; ++count )
+        {
+            block_type value = _data[count];
+            _data[count] = value - _value;
+            _value = value < _value;
+        }
+
+        return _value;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result = _left * _multiplier + _addend, returns the high block
+    inline block_type
+    mulAddBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _multiplier
+        ,   block_type _addend
+    ) noexcept
+    {
+        for( size_type count = 0; count < _leftSize; ++count )
+        {
+            block_type high;
+            block_type low = mulWide( _left[count], _multiplier, high );
+
+            low += _addend;
+            _addend = high + ( low < _addend );
+            _result[count] = low;
+        }
+
+        return _addend;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result += _left * _multiplier, returns the block carried out of _leftSize
+    inline block_type
+    addMulBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _multiplier
+    ) noexcept
+    {
+        block_type carry = 0;
+
+        for( size_type count = 0; count < _leftSize; ++count )
+        {
+            block_type high;
+            block_type low = mulWide( _left[count], _multiplier, high );
+
+            low += carry;
+            high += low < carry;
+            low += _result[count];
+            high += low < _result[count];
+
+            _result[count] = low;
+            carry = high;
+        }
+
+        return carry;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result -= _left * _multiplier, returns the block borrowed beyond _leftSize
+    inline block_type
+    subMulBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _multiplier
+    ) noexcept
+    {
+        block_type borrow = 0;
+
+        for( size_type count = 0; count < _leftSize; ++count )
+        {
+            block_type high;
+            block_type low = mulWide( _left[count], _multiplier, high );
+
+            low += borrow;
+            high += low < borrow;
+
+            block_type value = _result[count];
+            _result[count] = value - low;
+            borrow = high + ( value < low );
+        }
+
+        return borrow;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _quotient = _left / _divisor, returns the remainder; the dividend is
+    // shifted on the fly so that a single reciprocal serves every block
+    inline block_type
+    divBlock(
+            block_type * _quotient
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _divisor
+    ) noexcept
+    {
+        if( !_leftSize )
+            return 0;
+
+        unsigned shift = countLeadingZeros( _divisor );
+        block_type divisor = _divisor << shift;
+        block_type inverse = reciprocal( divisor );
+
+        block_type remainder = shift ? _left[_leftSize - 1] >> ( BlockBits - shift ) : 0;
+
+        for( size_type count = _leftSize; count-- > 0; )
+        {
+            block_type low = _left[count] << shift;
+            if( shift && count )
+                low |= _left[count - 1] >> ( BlockBits - shift );
+
+            _quotient[count] = divWide( remainder, low, divisor, inverse, remainder );
+        }
+
+        return remainder >> shift;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _left % _divisor
+    inline block_type
+    modBlock(
+            block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _divisor
+    ) noexcept
+    {
+        if( !_leftSize )
+            return 0;
+
+        unsigned shift = countLeadingZeros( _divisor );
+        block_type divisor = _divisor << shift;
+        block_type inverse = reciprocal( divisor );
+
+        block_type remainder = shift ? _left[_leftSize - 1] >> ( BlockBits - shift ) : 0;
+
+        for( size_type count = _leftSize; count-- > 0; )
+        {
+            block_type low = _left[count] << shift;
+            if( shift && count )
+                low |= _left[count - 1] >> ( BlockBits - shift );
+
+            divWide( remainder, low, divisor, inverse, remainder );
+        }
+
+        return remainder >> shift;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // three-way comparison of two arrays of the same size
+    inline int
+    compareBlocks(
+            block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    ) noexcept
+    {
+        for( size_type count = _size; count-- > 0; )
+            if( _left[count] != _right[count] )
+                return _left[count] < _right[count] ? -1 : 1;
+
+        return 0;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // number of significant blocks in the first _size ones
+    inline size_type
+    normalizedSize( block_type const* _data, size_type _size ) noexcept
+    {
+        while( _size && !_data[_size - 1] )
+            --_size;
+
+        return _size;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace BlockArithmetic
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_BLOCK_ARITHMETIC_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,532 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "carry_kernels.hpp"
+
+#if defined( BIG_INTEGER_X86_64_KERNELS )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace CarryKernels {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    block_type
+    addPortable(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        return BlockArithmetic::addBlocks( _result, _left, _size, _right, _size );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    block_type
+    subtractPortable(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        return BlockArithmetic::subBlocks( _result, _left, _size, _right, _size );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    block_type
+    addMulPortable(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _size
+        ,   block_type _multiplier
+    )
+    {
+        return BlockArithmetic::addMulBlock( _result, _left, _size, _multiplier );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#if defined( BIG_INTEGER_X86_64_KERNELS )
+
+/*-----------------------------------------------------------------------------------*/
+
+    // blocks left over by the unrolled loops, _carry is 0 or 1
+    block_type
+    addTail(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+        ,   block_type _carry
+    )
+    {
+        for( size_type count = 0; count < _size; ++count )
+        {
+            block_type sum = _left[count] + _carry;
+            _carry = sum < _carry;
+            sum += _right[count];
+            _carry += sum < _right[count];
+            _result[count] = sum;
+        }
+
+        return _carry;
+    }
+
+    block_type
+    subtractTail(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+        ,   block_type _borrow
+    )
+    {
+        for( size_type count = 0; count < _size; ++count )
+        {
+            block_type difference = _left[count] - _right[count];
+            block_type nextBorrow = _left[count] < _right[count];
+            nextBorrow += difference < _borrow;
+            _result[count] = difference - _borrow;
+            _borrow = nextBorrow;
+        }
+
+        return _borrow;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#if defined( _MSC_VER )
+
+/*-----------------------------------------------------------------------------------*/
+
+    // MSVC keeps the intrinsics on the flags, four blocks per iteration
+    block_type
+    addAdc(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        unsigned char carry = 0;
+        size_type count = 0;
+
+        for( ; count + 4 <= _size; count += 4 )
+        {
+            carry = _addcarry_u64( carry, _left[count], _right[count], _result + count );
+            carry = _addcarry_u64( carry, _left[count + 1], _right[count + 1], _result + count + 1 );
+            carry = _addcarry_u64( carry, _left[count + 2], _right[count + 2], _result + count + 2 );
+            carry = _addcarry_u64( carry, _left[count + 3], _right[count + 3], _result + count + 3 );
+        }
+
+        return addTail( _result + count, _left + count, _right + count, _size - count, carry );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    block_type
+    subtractAdc(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        unsigned char borrow = 0;
+        size_type count = 0;
+
+        for( ; count + 4 <= _size; count += 4 )
+        {
+            borrow = _subborrow_u64( borrow, _left[count], _right[count], _result + count );
+            borrow = _subborrow_u64( borrow, _left[count + 1], _right[count + 1], _result + count + 1 );
+            borrow = _subborrow_u64( borrow, _left[count + 2], _right[count + 2], _result + count + 2 );
+            borrow = _subborrow_u64( borrow, _left[count + 3], _right[count + 3], _result + count + 3 );
+        }
+
+        return subtractTail( _result + count, _left + count, _right + count, _size - count, borrow );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // MULX leaves the flags alone, so the high halves and the result blocks
+    // are accumulated on two independent carry chains (ADCX and ADOX)
+    block_type
+    addMulAdx(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _size
+        ,   block_type _multiplier
+    )
+    {
+        unsigned char productCarry = 0;
+        unsigned char resultCarry = 0;
+        block_type previousHigh = 0;
+
+        for( size_type count = 0; count < _size; ++count )
+        {
+            block_type high;
+            block_type low = _mulx_u64( _left[count], _multiplier, &high );
+
+            productCarry = _addcarryx_u64( productCarry, low, previousHigh, &low );
+            resultCarry = _addcarryx_u64( resultCarry, low, _result[count], _result + count );
+
+            previousHigh = high;
+        }
+
+        // the top high half is at most 2^64 - 2, both carries still fit
+        return previousHigh + productCarry + resultCarry;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#else
+
+/*-----------------------------------------------------------------------------------*/
+
+    // GCC and Clang spill the flags around the intrinsics, so the loops are
+    // written in assembly: DEC and LEA leave the carry flag alone
+    block_type
+    addAdc(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        block_type carry = 0;
+        size_type quads = _size / 4;
+
+        if( quads )
+        {
+            block_type first;
+            block_type second;
+
+            __asm__ volatile(
+                    "clc\n\t"
+                    "1:\n\t"
+                    "movq (%[left]), %[first]\n\t"
+                    "movq 8(%[left]), %[second]\n\t"
+                    "adcq (%[right]), %[first]\n\t"
+                    "adcq 8(%[right]), %[second]\n\t"
+                    "movq %[first], (%[result])\n\t"
+                    "movq %[second], 8(%[result])\n\t"
+                    "movq 16(%[left]), %[first]\n\t"
+                    "movq 24(%[left]), %[second]\n\t"
+                    "adcq 16(%[right]), %[first]\n\t"
+                    "adcq 24(%[right]), %[second]\n\t"
+                    "movq %[first], 16(%[result])\n\t"
+                    "movq %[second], 24(%[result])\n\t"
+                    "leaq 32(%[left]), %[left]\n\t"
+                    "leaq 32(%[right]), %[right]\n\t"
+                    "leaq 32(%[result]), %[result]\n\t"
+                    "decq %[quads]\n\t"
+                    "jnz 1b\n\t"
+                    "setc %b[carry]\n\t"
+                :   [result] "+r" ( _result )
+                ,   [left] "+r" ( _left )
+                ,   [right] "+r" ( _right )
+                ,   [quads] "+r" ( quads )
+                ,   [carry] "+r" ( carry )
+                ,   [first] "=&r" ( first )
+                ,   [second] "=&r" ( second )
+                :
+                :   "cc", "memory"
+            );
+        }
+
+        return addTail( _result, _left, _right, _size % 4, carry );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    block_type
+    subtractAdc(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        block_type borrow = 0;
+        size_type quads = _size / 4;
+
+        if( quads )
+        {
+            block_type first;
+            block_type second;
+
+            __asm__ volatile(
+                    "clc\n\t"
+                    "1:\n\t"
+                    "movq (%[left]), %[first]\n\t"
+                    "movq 8(%[left]), %[second]\n\t"
+                    "sbbq (%[right]), %[first]\n\t"
+                    "sbbq 8(%[right]), %[second]\n\t"
+                    "movq %[first], (%[result])\n\t"
+                    "movq %[second], 8(%[result])\n\t"
+                    "movq 16(%[left]), %[first]\n\t"
+                    "movq 24(%[left]), %[second]\n\t"
+                    "sbbq 16(%[right]), %[first]\n\t"
+                    "sbbq 24(%[right]), %[second]\n\t"
+                    "movq %[first], 16(%[result])\n\t"
+                    "movq %[second], 24(%[result])\n\t"
+                    "leaq 32(%[left]), %[left]\n\t"
+                    "leaq 32(%[right]), %[right]\n\t"
+                    "leaq 32(%[result]), %[result]\n\t"
+                    "decq %[quads]\n\t"
+                    "jnz 1b\n\t"
+                    "setc %b[borrow]\n\t"
+                :   [result] "+r" ( _result )
+                ,   [left] "+r" ( _left )
+                ,   [right] "+r" ( _right )
+                ,   [quads] "+r" ( quads )
+                ,   [borrow] "+r" ( borrow )
+                ,   [first] "=&r" ( first )
+                ,   [second] "=&r" ( second )
+                :
+                :   "cc", "memory"
+            );
+        }
+
+        return subtractTail( _result, _left, _right, _size % 4, borrow );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // MULX leaves the flags alone, so the high halves and the result blocks
+    // are accumulated on two independent carry chains (ADCX and ADOX);
+    // the index counts up to zero in RCX so that JRCXZ ends the loop
+    // without touching either flag
+    block_type
+    addMulAdx(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _size
+        ,   block_type _multiplier
+    )
+    {
+        if( !_size )
+            return 0;
+
+        block_type const* leftEnd = _left + _size;
+        block_type* resultEnd = _result + _size;
+
+        std::ptrdiff_t index = -static_cast< std::ptrdiff_t >( _size );
+        block_type previousHigh = 0;
+        block_type low;
+        block_type high;
+        block_type zero;
+
+        __asm__ volatile(
+                "xorl %k[zero], %k[zero]\n\t"
+                "1:\n\t"
+                "mulxq (%[left], %[index], 8), %[low], %[high]\n\t"
+                "adcxq %[previousHigh], %[low]\n\t"
+                "adoxq (%[result], %[index], 8), %[low]\n\t"
+                "movq %[low], (%[result], %[index], 8)\n\t"
+                "movq %[high], %[previousHigh]\n\t"
+                "leaq 1(%[index]), %[index]\n\t"
+                "jrcxz 2f\n\t"
+                "jmp 1b\n\t"
+                "2:\n\t"
+                "adcxq %[zero], %[previousHigh]\n\t"
+                "adoxq %[zero], %[previousHigh]\n\t"
+            :   [index] "+c" ( index )
+            ,   [previousHigh] "+r" ( previousHigh )
+            ,   [low] "=&r" ( low )
+            ,   [high] "=&r" ( high )
+            ,   [zero] "=&r" ( zero )
+            :   [left] "r" ( leftEnd )
+            ,   [result] "r" ( resultEnd )
+            ,   "d" ( _multiplier )
+            :   "cc", "memory"
+        );
+
+        // the top high half is at most 2^64 - 2, both carries still fit
+        return previousHigh;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // _MSC_VER
+
+/*-----------------------------------------------------------------------------------*/
+
+    bool
+    supportsAdx()
+    {
+        unsigned registers[4];
+
+#if defined( _MSC_VER )
+        int info[4];
+        __cpuid( info, 0 );
+        if( info[0] < 7 )
+            return false;
+
+        __cpuidex( info, 7, 0 );
+        for( int index = 0; index < 4; ++index )
+            registers[index] = static_cast< unsigned >( info[index] );
+#else
+        if( !__get_cpuid_count( 7, 0, &registers[0], &registers[1], &registers[2], &registers[3] ) )
+            return false;
+#endif
+
+        // leaf 7, EBX: bit 8 is BMI2 (MULX), bit 19 is ADX
+        unsigned const features = registers[1];
+
+        return ( features >> 8 & 1 ) && ( features >> 19 & 1 );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_X86_64_KERNELS
+
+/*-----------------------------------------------------------------------------------*/
+
+    Implementation const Portable{ "portable", addPortable, subtractPortable, addMulPortable };
+
+#if defined( BIG_INTEGER_X86_64_KERNELS )
+
+    Implementation const Adc{ "adc", addAdc, subtractAdc, addMulPortable };
+
+    Implementation const Adx{ "adc+mulx/adx", addAdc, subtractAdc, addMulAdx };
+
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+    Implementation
+    select()
+    {
+#if defined( BIG_INTEGER_X86_64_KERNELS )
+        return supportsAdx() ? Adx : Adc;
+#else
+        return Portable;
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+std::vector< Implementation > const&
+available()
+{
+    static std::vector< Implementation > const implementations = []
+    {
+        std::vector< Implementation > result{ Portable };
+
+#if defined( BIG_INTEGER_X86_64_KERNELS )
+        result.push_back( Adc );
+
+        if( supportsAdx() )
+            result.push_back( Adx );
+#endif
+
+        return result;
+    }();
+
+    return implementations;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Implementation const&
+selected()
+{
+    static Implementation const implementation = select();
+
+    return implementation;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+block_type
+addBlocks(
+        block_type * _result
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+) noexcept
+{
+    block_type carry = selected().m_add( _result, _left, _right, _rightSize );
+
+    // in place the carry only has to travel as far as it reaches
+    if( _result == _left )
+        return BlockArithmetic::incrementBlocks(
+                _result + _rightSize
+            ,   _leftSize - _rightSize
+            ,   carry
+        );
+
+    return BlockArithmetic::addBlock(
+            _result + _rightSize
+        ,   _left + _rightSize
+        ,   _leftSize - _rightSize
+        ,   carry
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+block_type
+subBlocks(
+        block_type * _result
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+) noexcept
+{
+    block_type borrow = selected().m_subtract( _result, _left, _right, _rightSize );
+
+    if( _result == _left )
+        return BlockArithmetic::decrementBlocks(
+                _result + _rightSize
+            ,   _leftSize - _rightSize
+            ,   borrow
+        );
+
+    return BlockArithmetic::subBlock(
+            _result + _rightSize
+        ,   _left + _rightSize
+        ,   _leftSize - _rightSize
+        ,   borrow
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+block_type
+addMulBlock(
+        block_type * _result
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type _multiplier
+) noexcept
+{
+    return selected().m_addMul( _result, _left, _leftSize, _multiplier );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace CarryKernels
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,110 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_CARRY_KERNELS_HPP_
+#define BIG_INTEGER_CARRY_KERNELS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Carry-propagating loops used on long operands. On x86-64 they run a
+*  single ADC/SBB flag chain (intrinsics on MSVC, inline assembly on GCC
+*  and Clang), the multiply-accumulate loop also has a MULX/ADX variant.
+*  The implementation is picked once, on first use, from what CPUID
+*  reports; defining BIG_INTEGER_PORTABLE_KERNELS forces the plain C++
+*  loops.
+*/
+
+#if !defined( BIG_INTEGER_PORTABLE_KERNELS ) && ( defined( __x86_64__ ) || defined( _M_X64 ) )
+#define BIG_INTEGER_X86_64_KERNELS
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace CarryKernels {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // loops over _size blocks of equally long operands
+    struct Implementation
+    {
+        char const* m_name;
+
+        // _result = _left + _right, returns carry out
+        block_type ( *m_add )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result = _left - _right, returns borrow out
+        block_type ( *m_subtract )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result += _left * _multiplier, returns the block carried out
+        block_type ( *m_addMul )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   size_type _size
+            ,   block_type _multiplier
+        );
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    // implementations the running CPU supports, the portable one first
+    std::vector< Implementation > const& available();
+
+    // the fastest of them, used by the functions below
+    Implementation const& selected();
+
+/*-----------------------------------------------------------------------------------*/
+
+    // same contracts as their BlockArithmetic counterparts
+    block_type addBlocks(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+    ) noexcept;
+
+    block_type subBlocks(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+    ) noexcept;
+
+    block_type addMulBlock(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type _multiplier
+    ) noexcept;
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace CarryKernels
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_CARRY_KERNELS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
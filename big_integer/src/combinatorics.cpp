@@ -0,0 +1,262 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "combinatorics.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using ProductTree::size_type;
+    using ProductTree::block_type;
+
+    // 20! is the largest factorial fitting in a block
+    constexpr size_type SmallFactorial = 20;
+
+    // binomial coefficients with n at most this many times k are built
+    // from the factorization, the others as a product divided by k!
+    constexpr size_type FactorizationRatio = 64;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // primes up to a limit, one bit per odd number
+    class Sieve
+    {
+        public:
+
+            explicit Sieve( size_type _limit )
+                :   m_limit{ _limit }
+                ,   m_composite( _limit / 2 + 1 )
+            {
+                for( size_type odd = 3; odd <= _limit / odd; odd += 2 )
+                {
+                    if( m_composite[odd / 2] )
+                        continue;
+
+                    for( size_type multiple = odd * odd; multiple <= _limit; multiple += 2 * odd )
+                        m_composite[multiple / 2] = true;
+                }
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // _body( p ) for every prime p up to _last
+            template< typename _Body >
+            void forEachPrime( size_type _last, _Body _body ) const
+            {
+                _last = std::min( _last, m_limit );
+
+                if( _last >= 2 )
+                    _body( 2 );
+
+                for( size_type odd = 3; odd <= _last; odd += 2 )
+                    if( !m_composite[odd / 2] )
+                        _body( odd );
+            }
+
+        private:
+
+            size_type m_limit;
+
+            std::vector< bool > m_composite;
+
+    }; // class Sieve
+
+/*-----------------------------------------------------------------------------------*/
+
+    // n! / ( n / 2 )!^2; a prime p divides it once for every odd quotient
+    // n / p^i, so that each prime power is at most n
+    BigInteger
+    swing( size_type _n, Sieve const& _sieve )
+    {
+        ProductTree::Factors factors;
+
+        _sieve.forEachPrime(
+                _n
+            ,   [&]( size_type _prime )
+                {
+                    size_type power = 1;
+
+                    for( size_type quotient = _n / _prime; quotient; quotient /= _prime )
+                        if( quotient & 1 )
+                            power *= _prime;
+
+                    if( power > 1 )
+                        factors.add( power );
+                }
+        );
+
+        return factors.multiply();
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    BigInteger
+    factorial( size_type _n, Sieve const& _sieve )
+    {
+        if( _n <= SmallFactorial )
+        {
+            ProductTree::Factors factors;
+
+            for( size_type factor = 2; factor <= _n; ++factor )
+                factors.add( factor );
+
+            return factors.multiply();
+        }
+
+        BigInteger result = factorial( _n / 2, _sieve );
+
+        result *= result;
+        result *= swing( _n, _sieve );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace ProductTree {
+
+/*-----------------------------------------------------------------------------------*/
+
+Factors::Factors() noexcept
+    :   m_packed{ 1 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Factors::add( block_type _factor )
+{
+    block_type high;
+    block_type low = BlockArithmetic::mulWide( m_packed, _factor, high );
+
+    if( !high )
+    {
+        m_packed = low;
+        return;
+    }
+
+    m_leaves.emplace_back();
+    m_leaves.back() += m_packed;
+
+    m_packed = _factor;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Factors::add( BigInteger _factor )
+{
+    m_leaves.push_back( std::move( _factor ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Factors::multiply()
+{
+    if( m_packed != 1 || m_leaves.empty() )
+    {
+        m_leaves.emplace_back();
+        m_leaves.back() += m_packed;
+    }
+
+    m_packed = 1;
+
+    // neighbours are multiplied pairwise, the odd one out waits for the
+    // next level
+    while( m_leaves.size() > 1 )
+    {
+        size_type pairs = m_leaves.size() / 2;
+
+        Parallel::forEach(
+                0
+            ,   pairs
+            ,   [this]( size_type _begin, size_type _end )
+                {
+                    for( size_type pair = _begin; pair < _end; ++pair )
+                        m_leaves[2 * pair] *= m_leaves[2 * pair + 1];
+                }
+        );
+
+        for( size_type pair = 1; pair < pairs; ++pair )
+            m_leaves[pair] = std::move( m_leaves[2 * pair] );
+
+        if( m_leaves.size() % 2 )
+            m_leaves[pairs++] = std::move( m_leaves.back() );
+
+        m_leaves.resize( pairs );
+    }
+
+    BigInteger result = std::move( m_leaves.front() );
+    m_leaves.clear();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace ProductTree
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+factorial( BigInteger::size_type _n )
+{
+    return factorial( _n, Sieve( _n ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+binomial( BigInteger::size_type _n, BigInteger::size_type _k )
+{
+    if( _k > _n )
+        return BigInteger();
+
+    _k = std::min( _k, _n - _k );
+
+    ProductTree::Factors factors;
+
+    if( _n / FactorizationRatio > _k )
+    {
+        for( size_type index = 0; index < _k; ++index )
+            factors.add( _n - index );
+
+        return factors.multiply() / factorial( _k );
+    }
+
+    // by Kummer's theorem p divides the coefficient once for every borrow
+    // subtracting k from n in base p, each prime power is at most n
+    Sieve( _n ).forEachPrime(
+            _n
+        ,   [&]( size_type _prime )
+            {
+                size_type power = 1;
+
+                for(
+                        size_type n = _n / _prime, k = _k / _prime, rest = ( _n - _k ) / _prime
+                    ;   n
+                    ;   n /= _prime, k /= _prime, rest /= _prime
+                )
+                    if( n - k - rest )
+                        power *= _prime;
+
+                if( power > 1 )
+                    factors.add( power );
+            }
+    );
+
+    return factors.multiply();
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,101 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_COMBINATORICS_HPP_
+#define BIG_INTEGER_COMBINATORICS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+#include <type_traits>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Products of many factors are multiplied along a balanced tree: the
+*  factors are paired up level by level, so that the operands of every
+*  multiplication are about the same size and the large ones are left to
+*  the fast algorithms. Factorials and binomial coefficients are assembled
+*  the same way from their prime factorization.
+*/
+
+namespace ProductTree {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = BigInteger::size_type;
+    using block_type = BigInteger::block_type;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // factors of a product, small ones packed together into single blocks
+    class Factors
+    {
+        public:
+
+            Factors() noexcept;
+
+            void add( block_type _factor );
+
+            void add( BigInteger _factor );
+
+            // the product of the factors added so far, 1 for none; the
+            // factors are consumed
+            BigInteger multiply();
+
+        private:
+
+            std::vector< BigInteger > m_leaves;
+
+            // product of the small factors not yet in m_leaves
+            block_type m_packed;
+
+    }; // class Factors
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace ProductTree
+
+/*-----------------------------------------------------------------------------------*/
+
+// product of a range of BigInteger or of unsigned integers
+template< typename _Range >
+BigInteger product( _Range const& _values );
+
+// n!, by the prime swing: n! = ( n / 2 )!^2 * swing( n ), the swing
+// built from its prime factorization
+BigInteger factorial( BigInteger::size_type _n );
+
+// n over k, 0 for k > n
+BigInteger binomial( BigInteger::size_type _n, BigInteger::size_type _k );
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Range >
+BigInteger
+product( _Range const& _values )
+{
+    ProductTree::Factors factors;
+
+    for( auto const& value : _values )
+    {
+        using Value = std::decay_t< decltype( value ) >;
+
+        if constexpr( std::is_integral_v< Value > )
+        {
+            static_assert( std::is_unsigned_v< Value >, "Factors must be unsigned" );
+            factors.add( ProductTree::block_type( value ) );
+        }
+        else
+            factors.add( BigInteger( value ) );
+    }
+
+    return factors.multiply();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_COMBINATORICS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
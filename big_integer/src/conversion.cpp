@@ -0,0 +1,285 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "conversion.hpp"
+#include "division.hpp"
+#include "multiplication.hpp"
+
+#include <deque>
+#include <memory_resource>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Conversion {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using Blocks = std::pmr::vector< block_type >;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // 10^( 19 * 2^k ) built by repeated squaring as deep as a conversion
+    // needs; a deque keeps references valid while the table grows, the
+    // powers and the scratch of the conversion come from one resource
+    class PowerTable
+    {
+        public:
+
+            explicit PowerTable( std::pmr::memory_resource * _resource )
+                :   m_powers( _resource )
+            {
+                m_powers.emplace_back( 1, DecimalBase );
+            }
+
+            std::pmr::memory_resource* resource() const noexcept
+            {
+                return m_powers.get_allocator().resource();
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            Blocks const& power( size_type _index )
+            {
+                while( m_powers.size() <= _index )
+                {
+                    Blocks const& last = m_powers.back();
+                    Blocks square( 2 * last.size(), resource() );
+
+                    Multiplication::square( square.data(), last.data(), last.size(), resource() );
+                    square.resize( BlockArithmetic::normalizedSize( square.data(), square.size() ) );
+
+                    m_powers.push_back( std::move( square ) );
+                }
+
+                return m_powers[_index];
+            }
+
+        private:
+
+            std::pmr::deque< Blocks > m_powers;
+
+    }; // class PowerTable
+
+/*-----------------------------------------------------------------------------------*/
+
+    size_type
+    parseSchoolbook( block_type * _result, char const* _digits, size_type _length )
+    {
+        size_type size = 0;
+
+        size_type chunkLength = _length % DecimalBaseDigits;
+        if( !chunkLength )
+            chunkLength = DecimalBaseDigits;
+
+        for( size_type position = 0; position < _length; )
+        {
+            block_type chunk = 0;
+            block_type multiplier = 1;
+
+            for( size_type count = 0; count < chunkLength; ++count, ++position )
+            {
+                chunk = chunk * 10 + ( _digits[position] - '0' );
+                multiplier *= 10;
+            }
+
+            block_type high = BlockArithmetic::mulAddBlock(
+                    _result
+                ,   _result
+                ,   size
+                ,   multiplier
+                ,   chunk
+            );
+
+            if( high )
+                _result[size++] = high;
+
+            chunkLength = DecimalBaseDigits;
+        }
+
+        return size;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // value = high digits * 10^( 19 * 2^k ) + low 19 * 2^k digits
+    size_type
+    parse(
+            block_type * _result
+        ,   char const* _digits
+        ,   size_type _length
+        ,   PowerTable & _powers
+    )
+    {
+        if( _length <= Threshold * DecimalBaseDigits )
+            return parseSchoolbook( _result, _digits, _length );
+
+        size_type index = 0;
+        while( ( DecimalBaseDigits << ( index + 1 ) ) < _length )
+            ++index;
+
+        size_type lowLength = DecimalBaseDigits << index;
+        size_type highLength = _length - lowLength;
+
+        Blocks high( blocksForDigits( highLength ), _powers.resource() );
+        size_type highSize = parse( high.data(), _digits, highLength, _powers );
+        size_type lowSize = parse( _result, _digits + highLength, lowLength, _powers );
+
+        if( !highSize )
+            return lowSize;
+
+        Blocks const& power = _powers.power( index );
+        Blocks product( highSize + power.size(), _powers.resource() );
+
+        Multiplication::multiply(
+                product.data()
+            ,   high.data()
+            ,   highSize
+            ,   power.data()
+            ,   power.size()
+            ,   _powers.resource()
+        );
+
+        size_type size = BlockArithmetic::normalizedSize( product.data(), product.size() );
+        block_type carry = BlockArithmetic::addBlocks( _result, product.data(), size, _result, lowSize );
+
+        if( carry )
+            _result[size++] = carry;
+
+        return size;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // writes the value right-aligned into _output[0, _width), which is
+    // already filled with zero characters; the value is below 10^_width
+    void
+    printSchoolbook(
+            char * _output
+        ,   size_type _width
+        ,   block_type const* _data
+        ,   size_type _size
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        Blocks quotient( _data, _data + _size, _resource );
+        char* position = _output + _width;
+
+        while( _size )
+        {
+            block_type chunk = BlockArithmetic::divBlock(
+                    quotient.data()
+                ,   quotient.data()
+                ,   _size
+                ,   DecimalBase
+            );
+
+            _size = BlockArithmetic::normalizedSize( quotient.data(), _size );
+
+            for( size_type count = 0; count < DecimalBaseDigits && ( _size || chunk ); ++count )
+            {
+                *--position = static_cast< char >( '0' + chunk % 10 );
+                chunk /= 10;
+            }
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    print(
+            char * _output
+        ,   size_type _width
+        ,   block_type const* _data
+        ,   size_type _size
+        ,   PowerTable & _powers
+    )
+    {
+        _size = BlockArithmetic::normalizedSize( _data, _size );
+
+        if( _size <= Threshold )
+        {
+            printSchoolbook( _output, _width, _data, _size, _powers.resource() );
+            return;
+        }
+
+        // 10^( 19 * 2^k ) takes about 2^k blocks, split near the middle
+        size_type index = 0;
+        while( ( size_type( 2 ) << ( index + 1 ) ) <= _size )
+            ++index;
+
+        Blocks const& power = _powers.power( index );
+        size_type lowWidth = DecimalBaseDigits << index;
+
+        Blocks quotient( _size - power.size() + 1, _powers.resource() );
+        Blocks remainder( power.size(), _powers.resource() );
+
+        Division::divide(
+                quotient.data()
+            ,   remainder.data()
+            ,   _data
+            ,   _size
+            ,   power.data()
+            ,   power.size()
+            ,   _powers.resource()
+        );
+
+        print( _output + _width - lowWidth, lowWidth, remainder.data(), remainder.size(), _powers );
+        print( _output, _width - lowWidth, quotient.data(), quotient.size(), _powers );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+blocksForDigits( size_type _length ) noexcept
+{
+    return _length / DecimalBaseDigits + 1;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+parseDecimal(
+        block_type * _result
+    ,   char const* _digits
+    ,   size_type _length
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    PowerTable powers( _resource );
+
+    return parse( _result, _digits, _length, powers );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+std::string
+toDecimal( block_type const* _data, size_type _size, std::pmr::memory_resource * _resource )
+{
+    if( !_size )
+        return "0";
+
+    // a block never takes more than 20 decimal digits
+    size_type width = _size * ( DecimalBaseDigits + 1 );
+    std::string result( width, '0' );
+
+    PowerTable powers( _resource );
+    print( &result[0], width, _data, _size, powers );
+
+    result.erase( 0, result.find_first_not_of( '0' ) );
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Conversion
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,71 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_CONVERSION_HPP_
+#define BIG_INTEGER_CONVERSION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+#include <memory_resource>
+#include <string>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Size (in blocks) up to which decimal conversion runs the quadratic
+*  chunk-by-chunk loop; bigger values are split recursively by powers
+*  10^( 19 * 2^k ). Can be overridden from the compiler command line.
+*/
+
+#ifndef BIG_INTEGER_CONVERSION_THRESHOLD
+#define BIG_INTEGER_CONVERSION_THRESHOLD 32
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Conversion {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+    constexpr size_type Threshold = BIG_INTEGER_CONVERSION_THRESHOLD;
+
+    // the biggest power of ten fitting into a block and its exponent
+    constexpr block_type DecimalBase = 10000000000000000000ull;
+
+    constexpr size_type DecimalBaseDigits = 19;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // blocks enough to hold a value of _length decimal digits
+    size_type blocksForDigits( size_type _length ) noexcept;
+
+    // _result gets the value of _length validated decimal digits,
+    // returns the number of significant blocks written; the scratch of
+    // both conversions comes from _resource
+    size_type parseDecimal(
+            block_type * _result
+        ,   char const* _digits
+        ,   size_type _length
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+    // decimal representation without leading zeros, "0" for zero
+    std::string toDecimal(
+            block_type const* _data
+        ,   size_type _size
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Conversion
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_CONVERSION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,335 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "division.hpp"
+#include "multiplication.hpp"
+
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Division {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using Blocks = std::pmr::vector< block_type >;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // Knuth's algorithm D for a divisor with the top bit set. The dividend
+    // has _quotientSize + _divisorSize blocks and is replaced by the
+    // remainder in its lowest _divisorSize blocks.
+    void
+    schoolbook(
+            block_type * _quotient
+        ,   block_type * _dividend
+        ,   size_type _quotientSize
+        ,   block_type const* _divisor
+        ,   size_type _divisorSize
+    )
+    {
+        block_type top = _divisor[_divisorSize - 1];
+        block_type next = _divisorSize > 1 ? _divisor[_divisorSize - 2] : 0;
+        block_type inverse = BlockArithmetic::reciprocal( top );
+
+        for( size_type position = _quotientSize; position-- > 0; )
+        {
+            block_type* window = _dividend + position;
+
+            block_type high = window[_divisorSize];
+            block_type middle = window[_divisorSize - 1];
+            block_type low = _divisorSize > 1 ? window[_divisorSize - 2] : 0;
+
+            block_type estimate;
+            block_type remainder;
+            bool overflow = false;
+
+            if( high >= top )
+            {
+                estimate = ~block_type( 0 );
+                remainder = middle + top;
+                overflow = remainder < top;
+            }
+            else
+                estimate = BlockArithmetic::divWide( high, middle, top, inverse, remainder );
+
+            // the second divisor block leaves the estimate at most one too big
+            while( !overflow )
+            {
+                block_type productHigh;
+                block_type productLow = BlockArithmetic::mulWide( estimate, next, productHigh );
+
+                if( productHigh < remainder || ( productHigh == remainder && productLow <= low ) )
+                    break;
+
+                --estimate;
+                remainder += top;
+                overflow = remainder < top;
+            }
+
+            block_type borrow = BlockArithmetic::subMulBlock( window, _divisor, _divisorSize, estimate );
+
+            if( window[_divisorSize] < borrow )
+            {
+                --estimate;
+                block_type carry = BlockArithmetic::addBlocks(
+                        window
+                    ,   window
+                    ,   _divisorSize
+                    ,   _divisor
+                    ,   _divisorSize
+                );
+                window[_divisorSize] += carry - borrow;
+            }
+            else
+                window[_divisorSize] -= borrow;
+
+            _quotient[position] = estimate;
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void divideThreeByTwo(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _dividend
+        ,   block_type const* _divisor
+        ,   size_type _half
+        ,   std::pmr::memory_resource * _resource
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+    // 2n / n blocks with _dividend < _divisor * B^n and a normalized divisor,
+    // the quotient gets n blocks and the remainder n blocks
+    void
+    divideTwoByOne(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _dividend
+        ,   block_type const* _divisor
+        ,   size_type _size
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        if( _size % 2 || _size < BurnikelZieglerThreshold )
+        {
+            // the dividend with a spare top block, then the quotient
+            Blocks scratch( 3 * _size + 2, 0, _resource );
+            block_type* dividend = scratch.data();
+            block_type* quotient = dividend + 2 * _size + 1;
+
+            std::copy( _dividend, _dividend + 2 * _size, dividend );
+            schoolbook( quotient, dividend, _size + 1, _divisor, _size );
+
+            std::copy_n( quotient, _size, _quotient );
+            std::copy_n( dividend, _size, _remainder );
+            return;
+        }
+
+        size_type half = _size / 2;
+
+        Blocks partial( 3 * half, _resource );
+        divideThreeByTwo( _quotient + half, partial.data() + half, _dividend + half, _divisor, half, _resource );
+
+        std::copy( _dividend, _dividend + half, partial.begin() );
+        divideThreeByTwo( _quotient, _remainder, partial.data(), _divisor, half, _resource );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // 3h / 2h blocks with _dividend < _divisor * B^h and a normalized divisor,
+    // the quotient gets h blocks and the remainder 2h blocks
+    void
+    divideThreeByTwo(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _dividend
+        ,   block_type const* _divisor
+        ,   size_type _half
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        block_type const* dividendTop = _dividend + 2 * _half;
+        block_type const* divisorTop = _divisor + _half;
+
+        // lowest dividend third below the remainder of the top two thirds,
+        // plus a block for the case when that remainder overflows
+        Blocks rest( 2 * _half + 1, 0, _resource );
+        std::copy( _dividend, _dividend + _half, rest.begin() );
+
+        if( BlockArithmetic::compareBlocks( dividendTop, divisorTop, _half ) < 0 )
+            divideTwoByOne( _quotient, rest.data() + _half, _dividend + _half, divisorTop, _half, _resource );
+        else
+        {
+            // the top thirds are equal, the quotient is B^h - 1
+            std::fill( _quotient, _quotient + _half, ~block_type( 0 ) );
+            rest[2 * _half] = BlockArithmetic::addBlocks(
+                    rest.data() + _half
+                ,   _dividend + _half
+                ,   _half
+                ,   divisorTop
+                ,   _half
+            );
+        }
+
+        Blocks product( 2 * _half, _resource );
+        Multiplication::multiply( product.data(), _quotient, _half, _divisor, _half, _resource );
+
+        block_type borrow = BlockArithmetic::subBlocks(
+                rest.data()
+            ,   rest.data()
+            ,   rest.size()
+            ,   product.data()
+            ,   product.size()
+        );
+
+        // at most two corrections are needed
+        block_type const one = 1;
+        while( borrow )
+        {
+            if( BlockArithmetic::addBlocks( rest.data(), rest.data(), rest.size(), _divisor, 2 * _half ) )
+                borrow = 0;
+
+            BlockArithmetic::subBlocks( _quotient, _quotient, _half, &one, 1 );
+        }
+
+        std::copy( rest.begin(), rest.begin() + 2 * _half, _remainder );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    divideSchoolbook(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        unsigned shift = BlockArithmetic::countLeadingZeros( _right[_rightSize - 1] );
+
+        Blocks divisor( _rightSize, _resource );
+        BlockArithmetic::shiftLeft( divisor.data(), _right, _rightSize, shift );
+
+        Blocks dividend( _leftSize + 1, _resource );
+        dividend[_leftSize] = BlockArithmetic::shiftLeft( dividend.data(), _left, _leftSize, shift );
+
+        schoolbook( _quotient, dividend.data(), _leftSize - _rightSize + 1, divisor.data(), _rightSize );
+
+        BlockArithmetic::shiftRight( _remainder, dividend.data(), _rightSize, shift );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // Burnikel and Ziegler, "Fast Recursive Division"
+    void
+    divideRecursive(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        // the divisor is padded to j * 2^k blocks with j below the threshold,
+        // so that halving it always ends in the schoolbook base case
+        size_type power = 1;
+        while( power * BurnikelZieglerThreshold <= _rightSize )
+            power *= 2;
+
+        size_type blockSize = ( _rightSize + power - 1 ) / power * power;
+        size_type padding = blockSize - _rightSize;
+        unsigned shift = BlockArithmetic::countLeadingZeros( _right[_rightSize - 1] );
+
+        Blocks divisor( blockSize, 0, _resource );
+        BlockArithmetic::shiftLeft( divisor.data() + padding, _right, _rightSize, shift );
+
+        Blocks dividend( _leftSize + padding + 1, 0, _resource );
+        dividend.back() = BlockArithmetic::shiftLeft( dividend.data() + padding, _left, _leftSize, shift );
+
+        // the top chunk must stay below half of B^blockSize
+        size_type dividendSize = BlockArithmetic::normalizedSize( dividend.data(), dividend.size() );
+        size_type chunks = ( dividendSize + blockSize - 1 ) / blockSize;
+        if( dividendSize == chunks * blockSize && dividend[dividendSize - 1] >> ( BlockArithmetic::BlockBits - 1 ) )
+            ++chunks;
+
+        chunks = std::max< size_type >( chunks, 2 );
+        dividend.resize( chunks * blockSize, 0 );
+
+        Blocks quotient( ( chunks - 1 ) * blockSize, _resource );
+        Blocks window( dividend.end() - 2 * blockSize, dividend.end(), _resource );
+        Blocks remainder( blockSize, _resource );
+
+        for( size_type chunk = chunks - 1; chunk-- > 0; )
+        {
+            divideTwoByOne(
+                    quotient.data() + chunk * blockSize
+                ,   remainder.data()
+                ,   window.data()
+                ,   divisor.data()
+                ,   blockSize
+                ,   _resource
+            );
+
+            if( chunk )
+            {
+                auto next = dividend.begin() + ( chunk - 1 ) * blockSize;
+                std::copy( next, next + blockSize, window.begin() );
+                std::copy( remainder.begin(), remainder.end(), window.begin() + blockSize );
+            }
+        }
+
+        size_type quotientSize = _leftSize - _rightSize + 1;
+        size_type copied = std::min( quotientSize, quotient.size() );
+
+        std::copy( quotient.begin(), quotient.begin() + copied, _quotient );
+        std::fill( _quotient + copied, _quotient + quotientSize, 0 );
+
+        BlockArithmetic::shiftRight( _remainder, remainder.data() + padding, _rightSize, shift );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+divide(
+        block_type * _quotient
+    ,   block_type * _remainder
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    if( _rightSize == 1 )
+        _remainder[0] = BlockArithmetic::divBlock( _quotient, _left, _leftSize, _right[0] );
+    else if(
+            _rightSize < BurnikelZieglerThreshold
+        ||  _leftSize - _rightSize < BurnikelZieglerThreshold
+    )
+        divideSchoolbook( _quotient, _remainder, _left, _leftSize, _right, _rightSize, _resource );
+    else
+        divideRecursive( _quotient, _remainder, _left, _leftSize, _right, _rightSize, _resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Division
+
+/*-----------------------------------------------------------------------------------*/
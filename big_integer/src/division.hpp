@@ -0,0 +1,61 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_DIVISION_HPP_
+#define BIG_INTEGER_DIVISION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+#include <memory_resource>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Divisor size (in blocks) from which division goes through the recursive
+*  Burnikel-Ziegler algorithm instead of the schoolbook one. Can be
+*  overridden from the compiler command line.
+*/
+
+#ifndef BIG_INTEGER_BURNIKEL_ZIEGLER_THRESHOLD
+#define BIG_INTEGER_BURNIKEL_ZIEGLER_THRESHOLD 64
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Division {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+    constexpr size_type BurnikelZieglerThreshold = BIG_INTEGER_BURNIKEL_ZIEGLER_THRESHOLD;
+
+    static_assert( BurnikelZieglerThreshold >= 2, "Burnikel-Ziegler threshold is too small" );
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _quotient[0, _leftSize - _rightSize + 1) = _left / _right,
+    // _remainder[0, _rightSize) = _left % _right;
+    // requires _leftSize >= _rightSize and a non-zero top block of _right,
+    // outputs must not overlap the inputs; the scratch comes from _resource
+    void divide(
+            block_type * _quotient
+        ,   block_type * _remainder
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Division
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_DIVISION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,286 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_EXPRESSION_HPP_
+#define BIG_INTEGER_EXPRESSION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Lazy +, - and * on BigInteger. An expression only records its operands;
+*  it is evaluated when it is assigned to or converted into a BigInteger.
+*  The destination reserves room for the whole chain first and every step
+*  then works in place: a + b + c + d or a * b + c costs at most one
+*  allocation. A product to the right of a sum or difference is evaluated
+*  into a temporary of its own, so a + b * c - d costs one more.
+*
+*  Operands are held by reference: an expression must not outlive the
+*  values it was built from, so do not keep one in an auto variable.
+*/
+
+namespace Expression {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = BigInteger::size_type;
+
+    struct Sum {};
+
+    struct Difference {};
+
+    struct Product {};
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< typename _Type >
+    struct IsExpression
+        :   std::false_type
+    {};
+
+    template< typename _Operation, typename _Left, typename _Right >
+    struct IsExpression< Binary< _Operation, _Left, _Right > >
+        :   std::true_type
+    {};
+
+    template< typename _Type >
+    struct IsOperand
+        :   std::bool_constant<
+                    std::is_same< _Type, BigInteger >::value
+                ||  IsExpression< _Type >::value
+            >
+    {};
+
+    // values are referenced, nested expressions are small and kept by value
+    template< typename _Type >
+    using Stored = std::conditional_t<
+            IsExpression< _Type >::value
+        ,   _Type
+        ,   _Type const&
+    >;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // evaluates into a fresh value with storage from _resource
+    template< typename _Expression >
+    BigInteger
+    evaluate( _Expression const& _expression, std::pmr::memory_resource * _resource )
+    {
+        BigInteger result( _resource );
+
+        result.reserve( _expression.sizeBound() );
+        _expression.evaluateInto( result );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline BigInteger const&
+    value( BigInteger const& _operand, std::pmr::memory_resource * ) noexcept
+    {
+        return _operand;
+    }
+
+    template< typename _Expression >
+    BigInteger
+    value( _Expression const& _operand, std::pmr::memory_resource * _resource )
+    {
+        return evaluate( _operand, _resource );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline size_type
+    sizeBound( BigInteger const& _operand ) noexcept
+    {
+        return _operand.getBlocksCount();
+    }
+
+    template< typename _Expression >
+    size_type
+    sizeBound( _Expression const& _operand ) noexcept
+    {
+        return _operand.sizeBound();
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline bool
+    refersTo( BigInteger const& _operand, BigInteger const* _target ) noexcept
+    {
+        return &_operand == _target;
+    }
+
+    template< typename _Expression >
+    bool
+    refersTo( _Expression const& _operand, BigInteger const* _target ) noexcept
+    {
+        return _operand.refersTo( _target );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< typename _Operation, typename _Left, typename _Right >
+    class Binary
+    {
+        public:
+
+            Binary( _Left const& _left, _Right const& _right )
+                :    m_left( _left )
+                ,    m_right( _right )
+            {}
+
+            /*-----------------------------------------------------------------------*/
+
+            // blocks enough to hold any intermediate result
+            size_type sizeBound() const noexcept
+            {
+                size_type left = Expression::sizeBound( m_left );
+                size_type right = Expression::sizeBound( m_right );
+
+                if constexpr( std::is_same< _Operation, Sum >::value )
+                    return std::max( left, right ) + 1;
+                else if constexpr( std::is_same< _Operation, Difference >::value )
+                    return left;
+                else
+                    return left + right;
+            }
+
+            bool refersTo( BigInteger const* _target ) const noexcept
+            {
+                return Expression::refersTo( m_left, _target )
+                    || Expression::refersTo( m_right, _target );
+            }
+
+            // whether evaluating into _target would overwrite a value that
+            // is still to be read; the left operand of a sum or difference
+            // may be _target itself, it is then simply updated in place
+            bool readsLate( BigInteger const* _target ) const noexcept
+            {
+                if constexpr( std::is_same< _Operation, Product >::value )
+                    return refersTo( _target );
+                else if constexpr( IsExpression< _Left >::value )
+                    return m_left.readsLate( _target )
+                        || Expression::refersTo( m_right, _target );
+                else
+                    return Expression::refersTo( m_right, _target );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            void evaluateInto( BigInteger & _result ) const
+            {
+                std::pmr::memory_resource* resource = _result.getResource();
+
+                if constexpr( std::is_same< _Operation, Product >::value )
+                {
+                    _result.assignProduct( value( m_left, resource ), value( m_right, resource ) );
+                }
+                else
+                {
+                    if constexpr( IsExpression< _Left >::value )
+                        m_left.evaluateInto( _result );
+                    else if( &m_left != &_result )
+                        _result = m_left;
+
+                    if constexpr( std::is_same< _Operation, Sum >::value )
+                        _result += value( m_right, resource );
+                    else
+                        _result -= value( m_right, resource );
+                }
+            }
+
+        private:
+
+            Stored< _Left > m_left;
+
+            Stored< _Right > m_right;
+
+    }; // class Binary
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Expression
+
+/*-----------------------------------------------------------------------------------*/
+
+template<
+        typename _Left
+    ,   typename _Right
+    ,   typename = std::enable_if_t<
+                Expression::IsOperand< _Left >::value
+            &&  Expression::IsOperand< _Right >::value
+        >
+>
+Expression::Binary< Expression::Sum, _Left, _Right >
+operator + ( _Left const& _left, _Right const& _right )
+{
+    return { _left, _right };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+// throws on evaluation when the result would be negative
+template<
+        typename _Left
+    ,   typename _Right
+    ,   typename = std::enable_if_t<
+                Expression::IsOperand< _Left >::value
+            &&  Expression::IsOperand< _Right >::value
+        >
+>
+Expression::Binary< Expression::Difference, _Left, _Right >
+operator - ( _Left const& _left, _Right const& _right )
+{
+    return { _left, _right };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template<
+        typename _Left
+    ,   typename _Right
+    ,   typename = std::enable_if_t<
+                Expression::IsOperand< _Left >::value
+            &&  Expression::IsOperand< _Right >::value
+        >
+>
+Expression::Binary< Expression::Product, _Left, _Right >
+operator * ( _Left const& _left, _Right const& _right )
+{
+    return { _left, _right };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Expression, typename >
+BigInteger::BigInteger( _Expression const& _expression )
+    :   BigInteger()
+{
+    reserve( _expression.sizeBound() );
+    _expression.evaluateInto( *this );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Expression, typename >
+BigInteger&
+BigInteger::operator = ( _Expression const& _expression )
+{
+    if( _expression.readsLate( this ) )
+        return *this = Expression::evaluate( _expression, m_resource );
+
+    reserve( _expression.sizeBound() );
+    _expression.evaluateInto( *this );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_EXPRESSION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,61 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "fixed_multiplier.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+FixedMultiplier::FixedMultiplier( BigInteger const& _factor )
+    :    m_factor{ _factor }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger const&
+FixedMultiplier::factor() const noexcept
+{
+    return m_factor;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+FixedMultiplier::multiply( BigInteger const& _other )
+{
+    BigInteger::size_type shorter = std::min( m_factor.m_size, _other.m_size );
+
+    if( shorter < Ntt::Threshold )
+        return m_factor * _other;
+
+    BigInteger::size_type resultSize = m_factor.m_size + _other.m_size;
+
+    BigInteger result;
+
+    spectrum( Ntt::transformLength( resultSize ) ).multiply(
+            result.allocate( resultSize )
+        ,    _other.m_pData
+        ,    _other.m_size
+        ,    result.m_resource
+    );
+
+    result.m_size = resultSize;
+    result.normalize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Ntt::Spectrum const&
+FixedMultiplier::spectrum( BigInteger::size_type _length )
+{
+    for( Ntt::Spectrum const& spectrum : m_spectra )
+        if( spectrum.length() == _length )
+            return spectrum;
+
+    m_spectra.emplace_back( m_factor.m_pData, m_factor.m_size, _length, m_factor.m_resource );
+
+    return m_spectra.back();
+}
+
+/*-----------------------------------------------------------------------------------*/
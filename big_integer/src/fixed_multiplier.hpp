@@ -0,0 +1,51 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_FIXED_MULTIPLIER_HPP_
+#define BIG_INTEGER_FIXED_MULTIPLIER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+#include "ntt.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Multiplies many values by the same factor. When the product goes through
+*  the transform path, the transform of the factor is computed once per
+*  transform length and reused by every later multiplication.
+*/
+
+class FixedMultiplier
+{
+    public:
+
+        explicit FixedMultiplier( BigInteger const& _factor );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger const& factor() const noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger multiply( BigInteger const& _other );
+
+    private:
+
+        Ntt::Spectrum const& spectrum( BigInteger::size_type _length );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger m_factor;
+
+        std::vector< Ntt::Spectrum > m_spectra;
+
+}; // class FixedMultiplier
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_FIXED_MULTIPLIER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
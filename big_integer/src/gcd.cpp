@@ -0,0 +1,714 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "gcd.hpp"
+#include "carry_kernels.hpp"
+#include "messages.hpp"
+
+#include <algorithm>
+#include <limits>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Every step replaces a pair (left, right) by the pair M^-1 * (left, right)
+*  for a matrix M of non-negative entries and determinant 1, which leaves
+*  the gcd unchanged; the product of all the matrices yields the Bezout
+*  coefficients. Steps are computed from the leading bits of the operands
+*  only: with leading parts x, y reduced to ( x', y' ) = M^-1 * ( x, y ),
+*  the full values stay non-negative as long as x' >= m01 and y' >= m10,
+*  whatever the lower bits were. Lehmer's algorithm applies this to the
+*  leading 127 bits, the half-GCD to the leading half of the blocks,
+*  recursively.
+*/
+
+class Euclid
+{
+    public:
+
+        using size_type = BigInteger::size_type;
+        using block_type = BigInteger::block_type;
+
+        template< typename _Entry >
+        struct Matrix
+        {
+            _Entry m_00;
+
+            _Entry m_01;
+
+            _Entry m_10;
+
+            _Entry m_11;
+        };
+
+        using SmallMatrix = Matrix< block_type >;
+        using LargeMatrix = Matrix< BigInteger >;
+
+        static constexpr size_type HalfGcdThreshold = BIG_INTEGER_HALF_GCD_THRESHOLD;
+
+        /*---------------------------------------------------------------------------*/
+
+        // reduces the pair until one of the values is zero, the other one is
+        // the gcd then; _matrix, when given, accumulates the steps
+        static void reduce( BigInteger & _left, BigInteger & _right, LargeMatrix * _matrix );
+
+        static LargeMatrix identity();
+
+    private:
+
+#ifdef __SIZEOF_INT128__
+        using Window = unsigned __int128;
+#else
+        using Window = block_type;
+#endif
+
+        // a bit less than the window holds, a remainder plus an entry of
+        // the matrix never overflows
+        static constexpr size_type WindowBits = 8 * sizeof( Window ) - 1;
+
+        /*---------------------------------------------------------------------------*/
+
+        // brings the pair to about half its size by a matrix that keeps
+        // _left >= m01 and _right >= m10, so that it is also valid for any
+        // values these are the leading blocks of
+        static void halfReduce( BigInteger & _left, BigInteger & _right, LargeMatrix & _matrix );
+
+        // halfReduce() below the threshold, by Lehmer steps
+        static void lehmerReduce( BigInteger & _left, BigInteger & _right, LargeMatrix & _matrix );
+
+        // applies _step, which reduced the blocks of the pair from _split
+        // on to _topLeft and _topRight, to the pair and _matrix if the
+        // result still meets the condition of halfReduce()
+        static bool tryStep(
+                BigInteger & _left
+            ,   BigInteger & _right
+            ,   LargeMatrix & _matrix
+            ,   LargeMatrix const& _step
+            ,   BigInteger const& _topLeft
+            ,   BigInteger const& _topRight
+            ,   size_type _split
+        );
+
+        // full quotient step of the larger value by the smaller one
+        static void divisionStep( BigInteger & _left, BigInteger & _right, LargeMatrix * _matrix );
+
+        /*---------------------------------------------------------------------------*/
+
+        // matrix of a Lehmer step on the leading bits, false when these allow none
+        static bool lehmerMatrix( BigInteger const& _left, BigInteger const& _right, SmallMatrix & _matrix ) noexcept;
+
+        // the whole Euclidean algorithm on single-block values
+        static SmallMatrix euclidMatrix( block_type _left, block_type _right ) noexcept;
+
+        static size_type bitLength( BigInteger const& _value ) noexcept;
+
+        // WindowBits bits of _value from bit _shift on
+        static Window leadingBits( BigInteger const& _value, size_type _shift ) noexcept;
+
+        // the blocks of _value from _blocks on
+        static BigInteger top( BigInteger const& _value, size_type _blocks );
+
+        // the blocks of _value below _blocks, read in place
+        static BigInteger bottom( BigInteger const& _value, size_type _blocks ) noexcept;
+
+        // _value * 2^( 64 * _blocks )
+        static BigInteger shifted( BigInteger const& _value, size_type _blocks );
+
+        static bool isIdentity( LargeMatrix const& _matrix ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        // ( _left, _right ) = _step^-1 * ( _left, _right ), the new values
+        // are built in the scratch objects and swapped in
+        static void applyInverse(
+                SmallMatrix const& _step
+            ,   BigInteger & _left
+            ,   BigInteger & _right
+            ,   BigInteger & _scratchLeft
+            ,   BigInteger & _scratchRight
+        );
+
+        static LargeMatrix product( LargeMatrix const& _left, SmallMatrix const& _right );
+
+        static LargeMatrix product( LargeMatrix const& _left, LargeMatrix const& _right );
+
+        // _result = _first * _firstFactor - _second * _secondFactor, known to be non-negative
+        static void combineDifference(
+                BigInteger & _result
+            ,   BigInteger const& _first
+            ,   block_type _firstFactor
+            ,   BigInteger const& _second
+            ,   block_type _secondFactor
+        );
+
+        // _first * _firstFactor + _second * _secondFactor
+        static BigInteger combineSum(
+                BigInteger const& _first
+            ,   block_type _firstFactor
+            ,   BigInteger const& _second
+            ,   block_type _secondFactor
+        );
+
+}; // class Euclid
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::reduce( BigInteger & _left, BigInteger & _right, LargeMatrix * _matrix )
+{
+    BigInteger scratchLeft;
+    BigInteger scratchRight;
+
+    while( _left.m_size && _right.m_size )
+    {
+        size_type size = std::max( _left.m_size, _right.m_size );
+
+        if( size >= HalfGcdThreshold )
+        {
+            LargeMatrix step;
+            halfReduce( _left, _right, step );
+
+            if( !isIdentity( step ) )
+            {
+                if( _matrix )
+                    *_matrix = product( *_matrix, step );
+
+                continue;
+            }
+        }
+
+        SmallMatrix step;
+
+        if( size == 1 )
+            step = euclidMatrix( _left.m_pData[0], _right.m_pData[0] );
+        else if( !lehmerMatrix( _left, _right, step ) )
+        {
+            divisionStep( _left, _right, _matrix );
+            continue;
+        }
+
+        applyInverse( step, _left, _right, scratchLeft, scratchRight );
+
+        if( _matrix )
+            *_matrix = product( *_matrix, step );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::LargeMatrix
+Euclid::identity()
+{
+    LargeMatrix result;
+
+    result.m_00 = 1_b;
+    result.m_11 = 1_b;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::halfReduce( BigInteger & _left, BigInteger & _right, LargeMatrix & _matrix )
+{
+    _matrix = identity();
+
+    size_type size = std::max( _left.m_size, _right.m_size );
+
+    if( size < HalfGcdThreshold )
+    {
+        lehmerReduce( _left, _right, _matrix );
+        return;
+    }
+
+    // the upper half reduced to a quarter brings the pair to three quarters
+    LargeMatrix step;
+    size_type split = size / 2;
+
+    BigInteger left = top( _left, split );
+    BigInteger right = top( _right, split );
+    halfReduce( left, right, step );
+
+    if( isIdentity( step ) || !tryStep( _left, _right, _matrix, step, left, right, split ) )
+        return;
+
+    // the quarter still to go comes from the blocks above the size of the
+    // matrix, so that the values remain larger than its entries
+    split = std::max( {
+            _matrix.m_00.m_size
+        ,   _matrix.m_01.m_size
+        ,   _matrix.m_10.m_size
+        ,   _matrix.m_11.m_size
+    } ) + 1;
+    size = std::max( _left.m_size, _right.m_size );
+
+    if( size <= split + 2 )
+        return;
+
+    left = top( _left, split );
+    right = top( _right, split );
+    halfReduce( left, right, step );
+
+    if( !isIdentity( step ) )
+        tryStep( _left, _right, _matrix, step, left, right, split );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::lehmerReduce( BigInteger & _left, BigInteger & _right, LargeMatrix & _matrix )
+{
+    BigInteger left;
+    BigInteger right;
+    SmallMatrix step;
+
+    while( lehmerMatrix( _left, _right, step ) )
+    {
+        combineDifference( left, _left, step.m_11, _right, step.m_01 );
+        combineDifference( right, _right, step.m_00, _left, step.m_10 );
+
+        LargeMatrix matrix = product( _matrix, step );
+
+        if( left < matrix.m_01 || right < matrix.m_10 )
+            return;
+
+        std::swap( _left, left );
+        std::swap( _right, right );
+        _matrix = std::move( matrix );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Euclid::tryStep(
+        BigInteger & _left
+    ,   BigInteger & _right
+    ,   LargeMatrix & _matrix
+    ,   LargeMatrix const& _step
+    ,   BigInteger const& _topLeft
+    ,   BigInteger const& _topRight
+    ,   size_type _split
+)
+{
+    // only the lower blocks are left to multiply by the inverse
+    // ( m11, -m01; -m10, m00 ), the result is non-negative as a whole
+    BigInteger lowLeft = bottom( _left, _split );
+    BigInteger lowRight = bottom( _right, _split );
+
+    BigInteger left = shifted( _topLeft, _split ) + _step.m_11 * lowLeft;
+    left -= _step.m_01 * lowRight;
+
+    BigInteger right = shifted( _topRight, _split ) + _step.m_00 * lowRight;
+    right -= _step.m_10 * lowLeft;
+
+    LargeMatrix matrix = product( _matrix, _step );
+
+    if( left < matrix.m_01 || right < matrix.m_10 )
+        return false;
+
+    _left = std::move( left );
+    _right = std::move( right );
+    _matrix = std::move( matrix );
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::divisionStep( BigInteger & _left, BigInteger & _right, LargeMatrix * _matrix )
+{
+    bool leftLarger = _left >= _right;
+
+    BigInteger& larger = leftLarger ? _left : _right;
+    BigInteger const& smaller = leftLarger ? _right : _left;
+
+    if( !_matrix )
+    {
+        larger %= smaller;
+        return;
+    }
+
+    auto [quotient, remainder] = divmod( larger, smaller );
+    larger = std::move( remainder );
+
+    if( leftLarger )
+    {
+        _matrix->m_01 += quotient * _matrix->m_00;
+        _matrix->m_11 += quotient * _matrix->m_10;
+    }
+    else
+    {
+        _matrix->m_00 += quotient * _matrix->m_01;
+        _matrix->m_10 += quotient * _matrix->m_11;
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Euclid::lehmerMatrix( BigInteger const& _left, BigInteger const& _right, SmallMatrix & _matrix ) noexcept
+{
+    constexpr Window Limit = std::numeric_limits< block_type >::max();
+
+    size_type bits = std::max( bitLength( _left ), bitLength( _right ) );
+    size_type shift = bits > WindowBits ? bits - WindowBits : 0;
+
+    Window x = leadingBits( _left, shift );
+    Window y = leadingBits( _right, shift );
+
+    Window m00 = 1, m01 = 0, m10 = 0, m11 = 1;
+
+    // the largest quotient keeping x >= m01 and y >= m10 at every step;
+    // one that is cut short ends the reduction, so the quotients left
+    // whole are those of the full values
+    for( ;; )
+    {
+        if( x >= y )
+        {
+            Window limit = x - m01;
+            Window divisor = y + m00;
+
+            if( limit < divisor )
+                break;
+
+            Window quotient = limit - divisor < divisor ? 1 : limit / divisor;
+
+            Window next01 = m01 + quotient * m00;
+            Window next11 = m11 + quotient * m10;
+
+            if( next01 > Limit || next11 > Limit )
+                break;
+
+            x -= quotient * y;
+            m01 = next01;
+            m11 = next11;
+        }
+        else
+        {
+            Window limit = y - m10;
+            Window divisor = x + m11;
+
+            if( limit < divisor )
+                break;
+
+            Window quotient = limit - divisor < divisor ? 1 : limit / divisor;
+
+            Window next00 = m00 + quotient * m01;
+            Window next10 = m10 + quotient * m11;
+
+            if( next00 > Limit || next10 > Limit )
+                break;
+
+            y -= quotient * x;
+            m00 = next00;
+            m10 = next10;
+        }
+    }
+
+    _matrix = {
+            static_cast< block_type >( m00 )
+        ,   static_cast< block_type >( m01 )
+        ,   static_cast< block_type >( m10 )
+        ,   static_cast< block_type >( m11 )
+    };
+
+    return m01 || m10;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::SmallMatrix
+Euclid::euclidMatrix( block_type _left, block_type _right ) noexcept
+{
+    // the entries end up at most max( _left, _right ) / gcd
+    SmallMatrix result{ 1, 0, 0, 1 };
+
+    while( _left && _right )
+    {
+        if( _left >= _right )
+        {
+            block_type quotient = _left / _right;
+            _left -= quotient * _right;
+            result.m_01 += quotient * result.m_00;
+            result.m_11 += quotient * result.m_10;
+        }
+        else
+        {
+            block_type quotient = _right / _left;
+            _right -= quotient * _left;
+            result.m_00 += quotient * result.m_01;
+            result.m_10 += quotient * result.m_11;
+        }
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::size_type
+Euclid::bitLength( BigInteger const& _value ) noexcept
+{
+    if( !_value.m_size )
+        return 0;
+
+    return _value.m_size * BlockArithmetic::BlockBits
+        -   BlockArithmetic::countLeadingZeros( _value.m_pData[_value.m_size - 1] );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::Window
+Euclid::leadingBits( BigInteger const& _value, size_type _shift ) noexcept
+{
+    auto blockAt = [&]( size_type _index ) -> block_type
+    {
+        return _index < _value.m_size ? _value.m_pData[_index] : 0;
+    };
+
+    size_type first = _shift / BlockArithmetic::BlockBits;
+    unsigned offset = _shift % BlockArithmetic::BlockBits;
+
+    Window result = 0;
+
+    for( size_type word = sizeof( Window ) / sizeof( block_type ); word-- > 0; )
+    {
+        block_type low = blockAt( first + word );
+        block_type high = blockAt( first + word + 1 );
+
+        block_type bits = offset
+            ?   low >> offset | high << ( BlockArithmetic::BlockBits - offset )
+            :   low;
+
+        // two shifts, a single one by the width of Window is undefined
+        result = result << 32 << 32 | bits;
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Euclid::top( BigInteger const& _value, size_type _blocks )
+{
+    if( _value.m_size <= _blocks )
+        return BigInteger();
+
+    return BigInteger::fromBlocks( _value.m_pData + _blocks, _value.m_size - _blocks );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Euclid::bottom( BigInteger const& _value, size_type _blocks ) noexcept
+{
+    size_type size = std::min( _value.m_size, _blocks );
+
+    return BigInteger( _value.m_pData, BlockArithmetic::normalizedSize( _value.m_pData, size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Euclid::shifted( BigInteger const& _value, size_type _blocks )
+{
+    BigInteger result;
+
+    if( !_value.m_size )
+        return result;
+
+    block_type* blocks = result.allocate( _value.m_size + _blocks );
+
+    std::fill_n( blocks, _blocks, 0 );
+    std::copy_n( _value.m_pData, _value.m_size, blocks + _blocks );
+    result.m_size = _value.m_size + _blocks;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Euclid::isIdentity( LargeMatrix const& _matrix ) noexcept
+{
+    return !_matrix.m_01.m_size && !_matrix.m_10.m_size;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::applyInverse(
+        SmallMatrix const& _step
+    ,   BigInteger & _left
+    ,   BigInteger & _right
+    ,   BigInteger & _scratchLeft
+    ,   BigInteger & _scratchRight
+)
+{
+    // the inverse is ( m11, -m01; -m10, m00 )
+    combineDifference( _scratchLeft, _left, _step.m_11, _right, _step.m_01 );
+    combineDifference( _scratchRight, _right, _step.m_00, _left, _step.m_10 );
+
+    std::swap( _left, _scratchLeft );
+    std::swap( _right, _scratchRight );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::LargeMatrix
+Euclid::product( LargeMatrix const& _left, SmallMatrix const& _right )
+{
+    return {
+            combineSum( _left.m_00, _right.m_00, _left.m_01, _right.m_10 )
+        ,   combineSum( _left.m_00, _right.m_01, _left.m_01, _right.m_11 )
+        ,   combineSum( _left.m_10, _right.m_00, _left.m_11, _right.m_10 )
+        ,   combineSum( _left.m_10, _right.m_01, _left.m_11, _right.m_11 )
+    };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Euclid::LargeMatrix
+Euclid::product( LargeMatrix const& _left, LargeMatrix const& _right )
+{
+    return {
+            _left.m_00 * _right.m_00 + _left.m_01 * _right.m_10
+        ,   _left.m_00 * _right.m_01 + _left.m_01 * _right.m_11
+        ,   _left.m_10 * _right.m_00 + _left.m_11 * _right.m_10
+        ,   _left.m_10 * _right.m_01 + _left.m_11 * _right.m_11
+    };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Euclid::combineDifference(
+        BigInteger & _result
+    ,   BigInteger const& _first
+    ,   block_type _firstFactor
+    ,   BigInteger const& _second
+    ,   block_type _secondFactor
+)
+{
+    size_type size = std::max( _first.m_size, _second.m_size ) + 1;
+    block_type* result = _result.allocate( size );
+
+    result[_first.m_size] = BlockArithmetic::mulAddBlock(
+            result
+        ,   _first.m_pData
+        ,   _first.m_size
+        ,   _firstFactor
+        ,   0
+    );
+    std::fill( result + _first.m_size + 1, result + size, 0 );
+
+    block_type borrow = BlockArithmetic::subMulBlock(
+            result
+        ,   _second.m_pData
+        ,   _second.m_size
+        ,   _secondFactor
+    );
+    BlockArithmetic::decrementBlocks( result + _second.m_size, size - _second.m_size, borrow );
+
+    _result.m_size = size;
+    _result.normalize();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Euclid::combineSum(
+        BigInteger const& _first
+    ,   block_type _firstFactor
+    ,   BigInteger const& _second
+    ,   block_type _secondFactor
+)
+{
+    BigInteger result;
+
+    if( _first.m_size < _second.m_size )
+        return combineSum( _second, _secondFactor, _first, _firstFactor );
+
+    size_type size = _first.m_size + 2;
+    block_type* blocks = result.allocate( size );
+
+    blocks[_first.m_size] = BlockArithmetic::mulAddBlock(
+            blocks
+        ,   _first.m_pData
+        ,   _first.m_size
+        ,   _firstFactor
+        ,   0
+    );
+    blocks[_first.m_size + 1] = 0;
+
+    if( _second.m_size )
+    {
+        block_type carry = CarryKernels::addMulBlock(
+                blocks
+            ,   _second.m_pData
+            ,   _second.m_size
+            ,   _secondFactor
+        );
+        BlockArithmetic::incrementBlocks( blocks + _second.m_size, size - _second.m_size, carry );
+    }
+
+    result.m_size = size;
+    result.normalize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+gcd( BigInteger const& _left, BigInteger const& _right )
+{
+    BigInteger left = _left;
+    BigInteger right = _right;
+
+    Euclid::reduce( left, right, nullptr );
+
+    return left.getBlocksCount() ? left : right;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+ExtendedGcd
+xgcd( BigInteger const& _left, BigInteger const& _right )
+{
+    BigInteger left = _left;
+    BigInteger right = _right;
+
+    Euclid::LargeMatrix matrix = Euclid::identity();
+    Euclid::reduce( left, right, &matrix );
+
+    // ( _left, _right ) = matrix * ( gcd, 0 ) or matrix * ( 0, gcd ),
+    // the inverse matrix ( m11, -m01; -m10, m00 ) gives the coefficients
+    if( !right.getBlocksCount() )
+        return { std::move( left ), std::move( matrix.m_11 ), std::move( matrix.m_01 ), false };
+
+    return { std::move( right ), std::move( matrix.m_10 ), std::move( matrix.m_00 ), true };
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+inverse_mod( BigInteger const& _value, BigInteger const& _modulus )
+{
+    ExtendedGcd result = xgcd( _value % _modulus, _modulus );
+
+    if( result.m_gcd != 1_b )
+        throw std::logic_error( Messages::NotInvertible );
+
+    BigInteger factor = result.m_leftFactor % _modulus;
+
+    if( !result.m_leftNegative || !factor.getBlocksCount() )
+        return factor;
+
+    return _modulus - factor;
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,65 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_GCD_HPP_
+#define BIG_INTEGER_GCD_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Operand size (in blocks) from which the greatest common divisor is
+*  reduced by the recursive half-GCD, which does the work of many Lehmer
+*  steps in a few large multiplications. Can be overridden from the
+*  compiler command line.
+*/
+
+#ifndef BIG_INTEGER_HALF_GCD_THRESHOLD
+#define BIG_INTEGER_HALF_GCD_THRESHOLD 400
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Bezout coefficients of two values left and right:
+*
+*      m_gcd = m_leftFactor * left - m_rightFactor * right
+*
+*  or, when m_leftNegative is set,
+*
+*      m_gcd = m_rightFactor * right - m_leftFactor * left
+*
+*  For nonzero operands the factors are at most right / m_gcd and
+*  left / m_gcd respectively.
+*/
+
+struct ExtendedGcd
+{
+    BigInteger m_gcd;
+
+    BigInteger m_leftFactor;
+
+    BigInteger m_rightFactor;
+
+    bool m_leftNegative;
+};
+
+/*-----------------------------------------------------------------------------------*/
+
+// Lehmer's algorithm on the leading 127 bits of the operands, the half-GCD
+// from BIG_INTEGER_HALF_GCD_THRESHOLD blocks on; gcd( x, 0 ) = x
+BigInteger gcd( BigInteger const& _left, BigInteger const& _right );
+
+ExtendedGcd xgcd( BigInteger const& _left, BigInteger const& _right );
+
+// x < _modulus with _value * x = 1 mod _modulus, throws std::logic_error
+// when _value and _modulus are not coprime
+BigInteger inverse_mod( BigInteger const& _value, BigInteger const& _modulus );
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_GCD_HPP_
+
+/*-----------------------------------------------------------------------------------*/
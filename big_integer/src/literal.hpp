@@ -0,0 +1,128 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_LITERAL_HPP_
+#define BIG_INTEGER_LITERAL_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  123456789012345678901234567890_b is parsed by the compiler. Every
+*  distinct literal becomes one static BigInteger reading constant blocks,
+*  so using it costs neither parsing nor allocation at run time. The
+*  literal yields a const reference; copy it to get a modifiable value.
+*  Digit separators are allowed, anything but decimal digits is rejected
+*  at compile time.
+*/
+
+namespace Literal {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = BigInteger::size_type;
+    using block_type = BigInteger::block_type;
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< size_type _Capacity >
+    struct Blocks
+    {
+        block_type m_data[_Capacity];
+
+        size_type m_size;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    constexpr bool
+    isDecimal( char const* _digits, size_type _count ) noexcept
+    {
+        for( size_type index = 0; index < _count; ++index )
+            if( ( _digits[index] < '0' || _digits[index] > '9' ) && _digits[index] != '\'' )
+                return false;
+
+        return true;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // log2( 10 ) < 3.322, one spare block for the rounding
+    constexpr size_type
+    blocksForDigits( size_type _count ) noexcept
+    {
+        return _count * 3322 / 1000 / 64 + 1;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< char... _Digits >
+    constexpr auto
+    parse() noexcept
+    {
+        constexpr char digits[] = { _Digits... };
+        constexpr size_type count = sizeof...( _Digits );
+
+        static_assert( isDecimal( digits, count ), "BigInteger literals must be decimal integers" );
+
+        Blocks< blocksForDigits( count ) > result{};
+        size_type size = 0;
+
+        for( char digit : digits )
+        {
+            if( digit == '\'' )
+                continue;
+
+            // result = result * 10 + digit, on 32-bit halves to stay portable
+            block_type carry = digit - '0';
+
+            for( size_type index = 0; index < size; ++index )
+            {
+                block_type block = result.m_data[index];
+                block_type low = ( block & 0xFFFFFFFF ) * 10 + carry;
+                block_type high = ( block >> 32 ) * 10 + ( low >> 32 );
+
+                result.m_data[index] = high << 32 | ( low & 0xFFFFFFFF );
+                carry = high >> 32;
+            }
+
+            if( carry )
+                result.m_data[size++] = carry;
+        }
+
+        result.m_size = size;
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< char... _Digits >
+    struct Constant
+    {
+        static constexpr auto Parsed = parse< _Digits... >();
+
+        // constant-initialized, never touches the heap
+        static inline BigInteger const Value{ Parsed.m_data, Parsed.m_size };
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Literal
+
+/*-----------------------------------------------------------------------------------*/
+
+template< char... _Digits >
+BigInteger const&
+operator "" _b () noexcept
+{
+    return Literal::Constant< _Digits... >::Value;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_LITERAL_HPP_
+
+/*-----------------------------------------------------------------------------------*/
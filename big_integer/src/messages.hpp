@@ -13,6 +13,18 @@ namespace Messages {
 
     constexpr const char* const InvalidDigit    = "Digit is not a valid";
 
+    constexpr const char* const DivisionByZero  = "Division by zero";
+    constexpr const char* const EvenModulus     = "Modulus must be odd";
+    constexpr const char* const NegativeResult  = "Subtraction result is negative";
+    constexpr const char* const NotInvertible   = "Value is not invertible modulo the modulus";
+    constexpr const char* const ZeroDegree      = "Root degree must be positive";
+
+    constexpr const char* const SizeMismatch    = "Ranges differ in length";
+
+    constexpr const char* const TruncatedData   = "Binary data is truncated";
+
+    constexpr const char* const MisalignedData  = "Binary data is not 8-byte aligned";
+
 /*---------------------------------------------------------------------------*/
 
 }; // namespace Messages
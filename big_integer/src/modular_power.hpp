@@ -0,0 +1,155 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_MODULAR_POWER_HPP_
+#define BIG_INTEGER_MODULAR_POWER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Sliding-window exponentiation shared by the modular contexts. A context
+*  keeps residues as arrays of size() blocks in its own representation and
+*  provides
+*
+*      Blocks one() const;
+*      void multiply( Blocks & result, Blocks const& left, Blocks const& right, Blocks & scratch ) const;
+*      void square( Blocks & result, Blocks const& value, Blocks & scratch ) const;
+*/
+
+namespace ModularPower {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = BigInteger::size_type;
+    using block_type = BigInteger::block_type;
+    using Blocks = std::vector< block_type >;
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline size_type
+    bitLength( BigInteger const& _value ) noexcept
+    {
+        size_type blocks = _value.getBlocksCount();
+        if( !blocks )
+            return 0;
+
+        block_type top = _value.getBlock( blocks - 1 );
+        size_type bits = ( blocks - 1 ) * 64;
+
+        for( ; top; top >>= 1 )
+            ++bits;
+
+        return bits;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    inline bool
+    bit( BigInteger const& _value, size_type _position ) noexcept
+    {
+        return ( _value.getBlock( _position / 64 ) >> ( _position % 64 ) ) & 1;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // window width minimizing squarings plus table multiplications
+    inline size_type
+    windowSize( size_type _bits ) noexcept
+    {
+        constexpr size_type Limits[] = { 24, 80, 240, 672, 1792 };
+
+        size_type size = 1;
+        for( size_type limit : Limits )
+            if( _bits > limit )
+                ++size;
+
+        return size;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _base ^ _exponent, _base is already in the context representation
+    template< typename _Context >
+    Blocks
+    power( _Context const& _context, Blocks const& _base, BigInteger const& _exponent )
+    {
+        size_type bits = bitLength( _exponent );
+        if( !bits )
+            return _context.one();
+
+        size_type window = windowSize( bits );
+
+        Blocks scratch;
+        Blocks result;
+        Blocks temporary;
+
+        // odd powers base^1, base^3, ..., base^( 2^window - 1 )
+        std::vector< Blocks > table( size_type( 1 ) << ( window - 1 ) );
+        table[0] = _base;
+
+        if( table.size() > 1 )
+        {
+            Blocks square;
+            _context.square( square, _base, scratch );
+
+            for( size_type index = 1; index < table.size(); ++index )
+                _context.multiply( table[index], table[index - 1], square, scratch );
+        }
+
+        bool started = false;
+
+        for( size_type position = bits; position-- > 0; )
+        {
+            if( !bit( _exponent, position ) )
+            {
+                _context.square( temporary, result, scratch );
+                result.swap( temporary );
+                continue;
+            }
+
+            // the longest window of at most _window bits ending in a set bit
+            size_type low = position + 1 > window ? position + 1 - window : 0;
+            while( !bit( _exponent, low ) )
+                ++low;
+
+            size_type value = 0;
+            for( size_type index = position + 1; index-- > low; )
+                value = value << 1 | bit( _exponent, index );
+
+            if( started )
+            {
+                for( size_type count = low; count <= position; ++count )
+                {
+                    _context.square( temporary, result, scratch );
+                    result.swap( temporary );
+                }
+
+                _context.multiply( temporary, result, table[value >> 1], scratch );
+                result.swap( temporary );
+            }
+            else
+            {
+                result = table[value >> 1];
+                started = true;
+            }
+
+            position = low;
+        }
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace ModularPower
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_MODULAR_POWER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,288 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "montgomery_context.hpp"
+#include "barrett_context.hpp"
+#include "carry_kernels.hpp"
+#include "modular_power.hpp"
+#include "multiplication.hpp"
+#include "messages.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using Blocks = MontgomeryContext::Blocks;
+    using size_type = MontgomeryContext::size_type;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _value < 2^( 64 * _size ) as exactly _size blocks
+    Blocks
+    padded( BigInteger const& _value, size_type _size )
+    {
+        Blocks result( _size, 0 );
+
+        for( size_type index = 0; index < _value.getBlocksCount(); ++index )
+            result[index] = _value.getBlock( index );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // two's complement of the value, modulo 2^( 64 * size )
+    void
+    negate( Blocks & _value ) noexcept
+    {
+        for( auto& block : _value )
+            block = ~block;
+
+        BlockArithmetic::incrementBlocks( _value.data(), _value.size(), 1 );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+MontgomeryContext::MontgomeryContext( BigInteger const& _modulus )
+    :    m_modulus{ _modulus }
+    ,    m_modulusBlocks( _modulus.m_pData, _modulus.m_pData + _modulus.m_size )
+    ,    m_inverse{ 0 }
+{
+    if( !_modulus.m_size || !( _modulus.m_pData[0] & 1 ) )
+        throw std::logic_error( Messages::EvenModulus );
+
+    computeInverse();
+
+    size_type n = size();
+
+    Blocks power( 2 * n + 1, 0 );
+    power[n] = 1;
+    m_one = padded( BigInteger::fromBlocks( power.data(), n + 1 ) % m_modulus, n );
+
+    power[n] = 0;
+    power[2 * n] = 1;
+    m_rSquared = padded( BigInteger::fromBlocks( power.data(), 2 * n + 1 ) % m_modulus, n );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger const&
+MontgomeryContext::modulus() const noexcept
+{
+    return m_modulus;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+MontgomeryContext::multiply( BigInteger const& _left, BigInteger const& _right ) const
+{
+    // ( left * R ) * right / R
+    Blocks scratch;
+    Blocks result;
+
+    multiply( result, toMontgomery( _left ), padded( _right % m_modulus, size() ), scratch );
+
+    return BigInteger::fromBlocks( result.data(), result.size() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+MontgomeryContext::pow( BigInteger const& _base, BigInteger const& _exponent ) const
+{
+    return fromMontgomery( ModularPower::power( *this, toMontgomery( _base ), _exponent ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+MontgomeryContext::size_type
+MontgomeryContext::size() const noexcept
+{
+    return m_modulusBlocks.size();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+MontgomeryContext::Blocks
+MontgomeryContext::toMontgomery( BigInteger const& _value ) const
+{
+    Blocks scratch;
+    Blocks result;
+
+    multiply( result, padded( _value % m_modulus, size() ), m_rSquared, scratch );
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+MontgomeryContext::fromMontgomery( Blocks const& _value ) const
+{
+    size_type n = size();
+
+    Blocks scratch( 6 * n + 1, 0 );
+    std::copy_n( _value.data(), n, scratch.data() );
+
+    Blocks result;
+    reduce( result, scratch );
+
+    return BigInteger::fromBlocks( result.data(), result.size() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+MontgomeryContext::Blocks
+MontgomeryContext::one() const
+{
+    return m_one;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+MontgomeryContext::multiply(
+        Blocks & _result
+    ,   Blocks const& _left
+    ,   Blocks const& _right
+    ,   Blocks & _scratch
+) const
+{
+    size_type n = size();
+
+    _scratch.resize( 6 * n + 1 );
+    Multiplication::multiply( _scratch.data(), _left.data(), n, _right.data(), n );
+    _scratch[2 * n] = 0;
+
+    reduce( _result, _scratch );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+MontgomeryContext::square( Blocks & _result, Blocks const& _value, Blocks & _scratch ) const
+{
+    size_type n = size();
+
+    _scratch.resize( 6 * n + 1 );
+    Multiplication::square( _scratch.data(), _value.data(), n );
+    _scratch[2 * n] = 0;
+
+    reduce( _result, _scratch );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+MontgomeryContext::reduce( Blocks & _result, Blocks & _product ) const
+{
+    size_type n = size();
+    block_type* product = _product.data();
+
+    if( n < Threshold )
+    {
+        // clear one block at a time by adding a multiple of the modulus
+        for( size_type index = 0; index < n; ++index )
+        {
+            block_type carry = CarryKernels::addMulBlock(
+                    product + index
+                ,   m_modulusBlocks.data()
+                ,   n
+                ,   product[index] * m_inverse
+            );
+
+            BlockArithmetic::incrementBlocks( product + index + n, n + 1 - index, carry );
+        }
+    }
+    else
+    {
+        // q = ( product mod R ) * ( -m^-1 ) mod R, product + q * m is divisible by R
+        block_type* quotient = product + 2 * n + 1;
+        block_type* correction = quotient + 2 * n;
+
+        Multiplication::multiply( quotient, product, n, m_wideInverse.data(), n );
+        Multiplication::multiply( correction, quotient, n, m_modulusBlocks.data(), n );
+
+        product[2 * n] += CarryKernels::addBlocks( product, product, 2 * n, correction, 2 * n );
+    }
+
+    // the upper half is now below 2m
+    block_type const* value = product + n;
+    _result.assign( value, value + n );
+
+    if( value[n] || BlockArithmetic::compareBlocks( _result.data(), m_modulusBlocks.data(), n ) >= 0 )
+        BlockArithmetic::subBlocks( _result.data(), _result.data(), n, m_modulusBlocks.data(), n );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+MontgomeryContext::computeInverse()
+{
+    size_type n = size();
+    block_type low = m_modulusBlocks[0];
+
+    // an odd value is its own inverse modulo 8, every Newton step
+    // doubles the number of correct bits
+    block_type inverse = low;
+    for( int step = 0; step < 5; ++step )
+        inverse *= 2 - low * inverse;
+
+    m_inverse = 0 - inverse;
+
+    if( n < Threshold )
+        return;
+
+    // the same iteration on whole blocks: x += x * ( 1 - m * x )
+    Blocks wide{ inverse };
+
+    for( size_type known = 1; known < n; )
+    {
+        size_type next = std::min( 2 * known, n );
+
+        // m * x = 1 + error * B^known modulo B^next
+        Blocks product( next + known );
+        Multiplication::multiply( product.data(), m_modulusBlocks.data(), next, wide.data(), known );
+
+        Blocks correction( next );
+        Multiplication::multiply(
+                correction.data()
+            ,   wide.data()
+            ,   known
+            ,   product.data() + known
+            ,   next - known
+        );
+
+        correction.resize( next - known );
+        negate( correction );
+
+        wide.insert( wide.end(), correction.begin(), correction.end() );
+        known = next;
+    }
+
+    negate( wide );
+    m_wideInverse = std::move( wide );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+pow_mod(
+        BigInteger const& _base
+    ,   BigInteger const& _exponent
+    ,   BigInteger const& _modulus
+)
+{
+    if( _modulus.getBlocksCount() && ( _modulus.getBlock( 0 ) & 1 ) )
+        return MontgomeryContext( _modulus ).pow( _base, _exponent );
+
+    return BarrettContext( _modulus ).pow( _base, _exponent );
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,120 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_MONTGOMERY_CONTEXT_HPP_
+#define BIG_INTEGER_MONTGOMERY_CONTEXT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Modulus size (in blocks) from which Montgomery reduction goes through two
+*  multiplications by a precomputed inverse instead of the block-by-block
+*  loop. Can be overridden from the compiler command line.
+*/
+
+#ifndef BIG_INTEGER_MONTGOMERY_THRESHOLD
+#define BIG_INTEGER_MONTGOMERY_THRESHOLD 32
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Arithmetic modulo a fixed odd modulus m of n blocks. Residues are kept
+*  as x * R mod m with R = 2^( 64 * n ), so that every product is reduced
+*  without division. All the constants depending on the modulus are
+*  computed by the constructor; a context is immutable afterwards and can
+*  serve any number of exponentiations, from several threads as well.
+*/
+
+class MontgomeryContext
+{
+    public:
+
+        using size_type = BigInteger::size_type;
+        using block_type = BigInteger::block_type;
+        using Blocks = std::vector< block_type >;
+
+        static constexpr size_type Threshold = BIG_INTEGER_MONTGOMERY_THRESHOLD;
+
+        /*---------------------------------------------------------------------------*/
+
+        explicit MontgomeryContext( BigInteger const& _modulus );
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger const& modulus() const noexcept;
+
+        // _left * _right mod modulus()
+        BigInteger multiply( BigInteger const& _left, BigInteger const& _right ) const;
+
+        // _base ^ _exponent mod modulus(), sliding-window exponentiation
+        BigInteger pow( BigInteger const& _base, BigInteger const& _exponent ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        // residues in Montgomery form, size() blocks each
+
+        size_type size() const noexcept;
+
+        Blocks toMontgomery( BigInteger const& _value ) const;
+
+        BigInteger fromMontgomery( Blocks const& _value ) const;
+
+        Blocks one() const;
+
+        void multiply(
+                Blocks & _result
+            ,   Blocks const& _left
+            ,   Blocks const& _right
+            ,   Blocks & _scratch
+        ) const;
+
+        void square( Blocks & _result, Blocks const& _value, Blocks & _scratch ) const;
+
+    private:
+
+        // _result = _product / R mod m, _product holds 2n + 1 blocks in
+        // front of the scratch space and is destroyed
+        void reduce( Blocks & _result, Blocks & _product ) const;
+
+        void computeInverse();
+
+        /*---------------------------------------------------------------------------*/
+
+        BigInteger m_modulus;
+
+        Blocks m_modulusBlocks;
+
+        // -m^-1 mod 2^64
+        block_type m_inverse;
+
+        // -m^-1 mod R, only for moduli from the threshold on
+        Blocks m_wideInverse;
+
+        // R mod m and R^2 mod m
+        Blocks m_one;
+
+        Blocks m_rSquared;
+
+}; // class MontgomeryContext
+
+/*-----------------------------------------------------------------------------------*/
+
+// _base ^ _exponent mod _modulus; odd moduli go through MontgomeryContext,
+// even ones through BarrettContext
+BigInteger pow_mod(
+        BigInteger const& _base
+    ,   BigInteger const& _exponent
+    ,   BigInteger const& _modulus
+);
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_MONTGOMERY_CONTEXT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
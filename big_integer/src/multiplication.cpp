@@ -0,0 +1,531 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "multiplication.hpp"
+#include "carry_kernels.hpp"
+#include "ntt.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Multiplication {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    // scratch comes from the resource of the destination value
+    using Blocks = std::pmr::vector< block_type >;
+
+    // Toom-3 interpolation goes through negative values, the magnitude is
+    // always kept without leading zero blocks
+    struct SignedBlocks
+    {
+        Blocks m_data;
+
+        bool m_negative;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    // multiply() with a resource the tasks may share
+    void dispatch(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+    SignedBlocks
+    emptySigned( std::pmr::memory_resource * _resource )
+    {
+        return SignedBlocks{ Blocks( _resource ), false };
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    trim( Blocks & _blocks )
+    {
+        _blocks.resize( BlockArithmetic::normalizedSize( _blocks.data(), _blocks.size() ) );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    SignedBlocks
+    makeSigned( block_type const* _data, size_type _size, std::pmr::memory_resource * _resource )
+    {
+        _size = BlockArithmetic::normalizedSize( _data, _size );
+        return SignedBlocks{ Blocks( _data, _data + _size, _resource ), false };
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    int
+    compareMagnitude( Blocks const& _left, Blocks const& _right )
+    {
+        if( _left.size() != _right.size() )
+            return _left.size() < _right.size() ? -1 : 1;
+
+        return BlockArithmetic::compareBlocks( _left.data(), _right.data(), _left.size() );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _left + ( _negateRight ? -_right : _right )
+    SignedBlocks
+    addSigned( SignedBlocks const& _left, SignedBlocks const& _right, bool _negateRight )
+    {
+        bool rightNegative = _right.m_negative != _negateRight;
+        SignedBlocks result{ Blocks( _left.m_data.get_allocator() ), false };
+
+        if( _left.m_negative == rightNegative )
+        {
+            Blocks const& longer  = _left.m_data.size() >= _right.m_data.size() ? _left.m_data : _right.m_data;
+            Blocks const& shorter = _left.m_data.size() >= _right.m_data.size() ? _right.m_data : _left.m_data;
+
+            result.m_data.resize( longer.size() + 1 );
+            result.m_data.back() = BlockArithmetic::addBlocks(
+                    result.m_data.data()
+                ,   longer.data()
+                ,   longer.size()
+                ,   shorter.data()
+                ,   shorter.size()
+            );
+            result.m_negative = _left.m_negative;
+        }
+        else
+        {
+            bool leftBigger = compareMagnitude( _left.m_data, _right.m_data ) >= 0;
+            Blocks const& bigger  = leftBigger ? _left.m_data : _right.m_data;
+            Blocks const& smaller = leftBigger ? _right.m_data : _left.m_data;
+
+            result.m_data.resize( bigger.size() );
+            BlockArithmetic::subBlocks(
+                    result.m_data.data()
+                ,   bigger.data()
+                ,   bigger.size()
+                ,   smaller.data()
+                ,   smaller.size()
+            );
+            result.m_negative = leftBigger ? _left.m_negative : rightNegative;
+        }
+
+        trim( result.m_data );
+        if( result.m_data.empty() )
+            result.m_negative = false;
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    multiplySmall( SignedBlocks & _value, block_type _multiplier )
+    {
+        block_type high = BlockArithmetic::mulAddBlock(
+                _value.m_data.data()
+            ,   _value.m_data.data()
+            ,   _value.m_data.size()
+            ,   _multiplier
+            ,   0
+        );
+
+        if( high )
+            _value.m_data.push_back( high );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the division is known to leave no remainder
+    void
+    divideExact( SignedBlocks & _value, block_type _divisor )
+    {
+        BlockArithmetic::divBlock(
+                _value.m_data.data()
+            ,   _value.m_data.data()
+            ,   _value.m_data.size()
+            ,   _divisor
+        );
+
+        trim( _value.m_data );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    SignedBlocks
+    multiplySigned(
+            SignedBlocks const& _left
+        ,   SignedBlocks const& _right
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        if( _left.m_data.empty() || _right.m_data.empty() )
+            return emptySigned( _resource );
+
+        SignedBlocks result{ Blocks( _resource ), _left.m_negative != _right.m_negative };
+        result.m_data.resize( _left.m_data.size() + _right.m_data.size() );
+        dispatch(
+                result.m_data.data()
+            ,   _left.m_data.data()
+            ,   _left.m_data.size()
+            ,   _right.m_data.data()
+            ,   _right.m_data.size()
+            ,   _resource
+        );
+
+        trim( result.m_data );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result += _value << ( _shift blocks ), _value is non-negative here
+    void
+    accumulate(
+            block_type * _result
+        ,   size_type _resultSize
+        ,   SignedBlocks const& _value
+        ,   size_type _shift
+    )
+    {
+        CarryKernels::addBlocks(
+                _result + _shift
+            ,   _result + _shift
+            ,   _resultSize - _shift
+            ,   _value.m_data.data()
+            ,   _value.m_data.size()
+        );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    schoolbook(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+    )
+    {
+        _result[_leftSize] = BlockArithmetic::mulAddBlock(
+                _result
+            ,   _left
+            ,   _leftSize
+            ,   _right[0]
+            ,   0
+        );
+
+        for( size_type count = 1; count < _rightSize; ++count )
+            _result[_leftSize + count] = CarryKernels::addMulBlock(
+                    _result + count
+                ,   _left
+                ,   _leftSize
+                ,   _right[count]
+            );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _leftSize >= 2 * _rightSize, the longer operand is cut into pieces
+    // of the shorter one so that every partial product stays balanced
+    void
+    multiplyUnbalanced(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        Blocks product( 2 * _rightSize, _resource );
+
+        std::fill( _result, _result + _leftSize + _rightSize, 0 );
+
+        for( size_type offset = 0; offset < _leftSize; offset += _rightSize )
+        {
+            size_type pieceSize = std::min( _rightSize, _leftSize - offset );
+
+            dispatch( product.data(), _left + offset, pieceSize, _right, _rightSize, _resource );
+
+            // only the lowest _rightSize blocks overlap the previous piece
+            CarryKernels::addBlocks(
+                    _result + offset
+                ,   product.data()
+                ,   pieceSize + _rightSize
+                ,   _result + offset
+                ,   _rightSize
+            );
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    karatsuba(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        size_type half = ( _leftSize + 1 ) / 2;
+        size_type leftHigh = _leftSize - half;
+        size_type rightHigh = _rightSize - half;
+        size_type resultSize = _leftSize + _rightSize;
+
+        Blocks sums( 2 * ( half + 1 ), _resource );
+        block_type* leftSum = sums.data();
+        block_type* rightSum = leftSum + half + 1;
+
+        leftSum[half] = CarryKernels::addBlocks( leftSum, _left, half, _left + half, leftHigh );
+        rightSum[half] = CarryKernels::addBlocks( rightSum, _right, half, _right + half, rightHigh );
+
+        Blocks middle( 2 * ( half + 1 ), _resource );
+
+        // the three products write to separate places
+        Parallel::TaskGroup group;
+
+        if( Parallel::isWorthSplitting( half ) )
+        {
+            group.run( [=]{ dispatch( _result, _left, half, _right, half, _resource ); } );
+            group.run( [=]{ dispatch( _result + 2 * half, _left + half, leftHigh, _right + half, rightHigh, _resource ); } );
+        }
+        else
+        {
+            dispatch( _result, _left, half, _right, half, _resource );
+            dispatch( _result + 2 * half, _left + half, leftHigh, _right + half, rightHigh, _resource );
+        }
+
+        dispatch( middle.data(), leftSum, half + 1, rightSum, half + 1, _resource );
+        group.wait();
+
+        CarryKernels::subBlocks( middle.data(), middle.data(), middle.size(), _result, 2 * half );
+        CarryKernels::subBlocks(
+                middle.data()
+            ,   middle.data()
+            ,   middle.size()
+            ,   _result + 2 * half
+            ,   resultSize - 2 * half
+        );
+
+        CarryKernels::addBlocks(
+                _result + half
+            ,   _result + half
+            ,   resultSize - half
+            ,   middle.data()
+            ,   BlockArithmetic::normalizedSize( middle.data(), middle.size() )
+        );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // values of a0 + a1 * x + a2 * x^2 at 1, -1 and -2
+    void
+    evaluate(
+            block_type const* _data
+        ,   size_type _size
+        ,   size_type _third
+        ,   SignedBlocks & _atOne
+        ,   SignedBlocks & _atMinusOne
+        ,   SignedBlocks & _atMinusTwo
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        SignedBlocks low = makeSigned( _data, _third, _resource );
+        SignedBlocks middle = makeSigned( _data + _third, _third, _resource );
+        SignedBlocks high = makeSigned( _data + 2 * _third, _size - 2 * _third, _resource );
+
+        SignedBlocks outer = addSigned( low, high, false );
+
+        _atOne = addSigned( outer, middle, false );
+        _atMinusOne = addSigned( outer, middle, true );
+
+        _atMinusTwo = addSigned( _atMinusOne, high, false );
+        multiplySmall( _atMinusTwo, 2 );
+        _atMinusTwo = addSigned( _atMinusTwo, low, true );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // evaluation in 0, 1, -1, -2 and infinity with Bodrato's interpolation
+    void
+    toom3(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        size_type part = ( _leftSize + 2 ) / 3;
+        size_type resultSize = _leftSize + _rightSize;
+
+        // every value shares the resource, so that moves between them
+        // never copy
+        SignedBlocks leftOne = emptySigned( _resource );
+        SignedBlocks leftMinusOne = emptySigned( _resource );
+        SignedBlocks leftMinusTwo = emptySigned( _resource );
+        evaluate( _left, _leftSize, part, leftOne, leftMinusOne, leftMinusTwo, _resource );
+
+        SignedBlocks rightOne = emptySigned( _resource );
+        SignedBlocks rightMinusOne = emptySigned( _resource );
+        SignedBlocks rightMinusTwo = emptySigned( _resource );
+        evaluate( _right, _rightSize, part, rightOne, rightMinusOne, rightMinusTwo, _resource );
+
+        SignedBlocks first = emptySigned( _resource );
+        SignedBlocks atMinusOne = emptySigned( _resource );
+        SignedBlocks third = emptySigned( _resource );
+
+        // the five products are independent
+        Parallel::TaskGroup group;
+        auto run = [&]( std::function< void() > _task )
+        {
+            if( Parallel::isWorthSplitting( part ) )
+                group.run( std::move( _task ) );
+            else
+                _task();
+        };
+
+        run( [&]{ dispatch( _result, _left, part, _right, part, _resource ); } );
+        run(
+            [&]
+            {
+                dispatch(
+                        _result + 4 * part
+                    ,   _left + 2 * part
+                    ,   _leftSize - 2 * part
+                    ,   _right + 2 * part
+                    ,   _rightSize - 2 * part
+                    ,   _resource
+                );
+            }
+        );
+        run( [&]{ first = multiplySigned( leftOne, rightOne, _resource ); } );
+        run( [&]{ atMinusOne = multiplySigned( leftMinusOne, rightMinusOne, _resource ); } );
+
+        third = multiplySigned( leftMinusTwo, rightMinusTwo, _resource );
+        group.wait();
+
+        std::fill( _result + 2 * part, _result + 4 * part, 0 );
+
+        SignedBlocks atZero = makeSigned( _result, 2 * part, _resource );
+        SignedBlocks atInfinity = makeSigned( _result + 4 * part, resultSize - 4 * part, _resource );
+
+        third = addSigned( third, first, true );
+        divideExact( third, 3 );
+
+        first = addSigned( first, atMinusOne, true );
+        divideExact( first, 2 );
+
+        SignedBlocks second = addSigned( atMinusOne, atZero, true );
+
+        third = addSigned( second, third, true );
+        divideExact( third, 2 );
+        SignedBlocks doubledInfinity{ Blocks( atInfinity.m_data, _resource ), atInfinity.m_negative };
+        multiplySmall( doubledInfinity, 2 );
+        third = addSigned( third, doubledInfinity, false );
+
+        second = addSigned( second, first, false );
+        second = addSigned( second, atInfinity, true );
+
+        first = addSigned( first, third, true );
+
+        accumulate( _result, resultSize, first, part );
+        accumulate( _result, resultSize, second, 2 * part );
+        accumulate( _result, resultSize, third, 3 * part );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    dispatch(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        if( _leftSize < _rightSize )
+        {
+            std::swap( _left, _right );
+            std::swap( _leftSize, _rightSize );
+        }
+
+        if( !_rightSize )
+            std::fill( _result, _result + _leftSize, 0 );
+        else if( _rightSize < KaratsubaThreshold )
+            schoolbook( _result, _left, _leftSize, _right, _rightSize );
+        else if( _rightSize >= Ntt::Threshold )
+            Ntt::multiply( _result, _left, _leftSize, _right, _rightSize, _resource );
+        else if( _leftSize >= 2 * _rightSize )
+            multiplyUnbalanced( _result, _left, _leftSize, _right, _rightSize, _resource );
+        else if( _rightSize < Toom3Threshold || _rightSize <= 2 * ( ( _leftSize + 2 ) / 3 ) )
+            karatsuba( _result, _left, _leftSize, _right, _rightSize, _resource );
+        else
+            toom3( _result, _left, _leftSize, _right, _rightSize, _resource );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+multiply(
+        block_type * _result
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    // the tasks of a parallel multiplication allocate concurrently
+    Parallel::SharedResource shared( _resource );
+
+    dispatch( _result, _left, _leftSize, _right, _rightSize, shared.get() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+square(
+        block_type * _result
+    ,   block_type const* _data
+    ,   size_type _size
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    Parallel::SharedResource shared( _resource );
+
+    if( _size >= Ntt::Threshold )
+        Ntt::square( _result, _data, _size, shared.get() );
+    else
+        dispatch( _result, _data, _size, _data, _size, shared.get() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Multiplication
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,76 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_MULTIPLICATION_HPP_
+#define BIG_INTEGER_MULTIPLICATION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+#include <memory_resource>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Operand sizes (in blocks of the shorter factor) at which multiplication
+*  switches from the schoolbook kernel to Karatsuba and from Karatsuba to
+*  Toom-3. Both can be overridden from the compiler command line.
+*/
+
+#ifndef BIG_INTEGER_KARATSUBA_THRESHOLD
+#define BIG_INTEGER_KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef BIG_INTEGER_TOOM3_THRESHOLD
+#define BIG_INTEGER_TOOM3_THRESHOLD 160
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Multiplication {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+    constexpr size_type KaratsubaThreshold = BIG_INTEGER_KARATSUBA_THRESHOLD;
+
+    constexpr size_type Toom3Threshold = BIG_INTEGER_TOOM3_THRESHOLD;
+
+    // smaller cut-offs would make Karatsuba recurse into operands of the same size
+    static_assert( KaratsubaThreshold >= 4, "Karatsuba threshold is too small" );
+
+    static_assert( Toom3Threshold >= KaratsubaThreshold, "Toom-3 threshold is too small" );
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _result[0, _leftSize + _rightSize) = _left * _right,
+    // _result must not overlap any of the operands; the scratch of
+    // Karatsuba, Toom-3 and the transforms comes from _resource
+    void multiply(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+    // _result[0, 2 * _size) = _data * _data, no overlap allowed either
+    void square(
+            block_type * _result
+        ,   block_type const* _data
+        ,   size_type _size
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Multiplication
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_MULTIPLICATION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
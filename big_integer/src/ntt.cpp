@@ -0,0 +1,666 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "ntt.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Ntt {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    // Montgomery arithmetic modulo a prime p < 2^62 with R = 2^64,
+    // values passed around are always reduced below p
+    class PrimeField
+    {
+        public:
+
+            PrimeField( block_type _modulus, block_type _generator )
+                :   m_modulus{ _modulus }
+                ,   m_negInverse{ 0 }
+                ,   m_rSquared{ 0 }
+                ,   m_generator{ 0 }
+            {
+                // Newton iteration doubles the number of correct low bits
+                block_type inverse = _modulus;
+                for( int count = 0; count < 5; ++count )
+                    inverse *= 2 - _modulus * inverse;
+
+                m_negInverse = 0 - inverse;
+
+                block_type rModulo;
+                BlockArithmetic::divWide( 1, 0, _modulus, rModulo );
+
+                block_type high;
+                block_type low = BlockArithmetic::mulWide( rModulo, rModulo, high );
+                BlockArithmetic::divWide( high, low, _modulus, m_rSquared );
+
+                m_generator = toMontgomery( _generator );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            block_type modulus() const noexcept
+            {
+                return m_modulus;
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // _left * _right / R
+            block_type multiply( block_type _left, block_type _right ) const noexcept
+            {
+                block_type high;
+                block_type low = BlockArithmetic::mulWide( _left, _right, high );
+
+                block_type reducerHigh;
+                BlockArithmetic::mulWide( low * m_negInverse, m_modulus, reducerHigh );
+
+                // the low halves cancel out and carry exactly when low is not zero
+                return correct( high + reducerHigh + ( low != 0 ) - m_modulus );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            block_type add( block_type _left, block_type _right ) const noexcept
+            {
+                return correct( _left + _right - m_modulus );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            block_type subtract( block_type _left, block_type _right ) const noexcept
+            {
+                return correct( _left - _right );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // all the moduli are just below 2^62, so the two top bits of the
+            // value estimate its quotient with an error of at most one
+            block_type reduce( block_type _value ) const noexcept
+            {
+                _value -= ( _value >> 62 ) * m_modulus;
+                return correct( _value - m_modulus );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            block_type toMontgomery( block_type _value ) const noexcept
+            {
+                return multiply( reduce( _value ), m_rSquared );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // both the base and the result are in Montgomery form
+            block_type power( block_type _base, block_type _exponent ) const noexcept
+            {
+                block_type result = toMontgomery( 1 );
+
+                for( ; _exponent; _exponent >>= 1 )
+                {
+                    if( _exponent & 1 )
+                        result = multiply( result, _base );
+
+                    _base = multiply( _base, _base );
+                }
+
+                return result;
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // primitive root of unity of the power of two degree _length
+            block_type rootOfUnity( size_type _length ) const noexcept
+            {
+                return power( m_generator, ( m_modulus - 1 ) / _length );
+            }
+
+        private:
+
+            // adds the modulus back to a value in ( -p, p ) without branching,
+            // butterflies would mispredict about every other comparison
+            block_type correct( block_type _value ) const noexcept
+            {
+                return _value + ( m_modulus & ( 0 - ( _value >> 63 ) ) );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            block_type m_modulus;
+
+            block_type m_negInverse;
+
+            block_type m_rSquared;
+
+            block_type m_generator;
+
+    }; // class PrimeField
+
+/*-----------------------------------------------------------------------------------*/
+
+    // p - 1 is divisible by 2^46, 2^41 and 2^42 respectively
+    PrimeField const&
+    field( size_type _index )
+    {
+        static PrimeField const fields[PrimesCount] = {
+                PrimeField{ 0x3fffc00000000001ull, 11 }
+            ,   PrimeField{ 0x3fffbe0000000001ull, 3 }
+            ,   PrimeField{ 0x3fff840000000001ull, 19 }
+        };
+
+        return fields[_index];
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _roots[len + j] = w^j for the root w of degree 2 * len, Montgomery form
+    std::vector< block_type >
+    makeRoots( PrimeField const& _field, size_type _length, bool _inverse )
+    {
+        std::vector< block_type > roots( std::max< size_type >( _length, 2 ) );
+
+        block_type root = _field.rootOfUnity( _length );
+        if( _inverse )
+            root = _field.power( root, _length - 1 );
+
+        size_type half = _length / 2;
+        block_type current = _field.toMontgomery( 1 );
+
+        for( size_type count = 0; count < half; ++count )
+        {
+            roots[half + count] = current;
+            current = _field.multiply( current, root );
+        }
+
+        for( size_type count = half; count-- > 1; )
+            roots[count] = roots[2 * count];
+
+        return roots;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the layout of makeRoots does not depend on the length, so a single
+    // table per prime and direction serves every shorter transform too
+    std::shared_ptr< std::vector< block_type > const >
+    rootsTable( size_type _index, size_type _length, bool _inverse )
+    {
+        static std::mutex mutex;
+        static std::shared_ptr< std::vector< block_type > const > tables[PrimesCount][2];
+
+        std::lock_guard< std::mutex > lock( mutex );
+
+        auto& table = tables[_index][_inverse];
+        if( !table || table->size() < _length )
+            table = std::make_shared< std::vector< block_type > const >(
+                makeRoots( field( _index ), _length, _inverse )
+            );
+
+        return table;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // decimation in frequency, natural order in, bit-reversed order out;
+    // long transforms run their first level in parallel, then both halves
+    // as independent transforms
+    void
+    forwardTransform(
+            PrimeField const& _field
+        ,   block_type * _data
+        ,   size_type _length
+        ,   std::vector< block_type > const& _roots
+    )
+    {
+        if( Parallel::isWorthSplitting( _length ) )
+        {
+            size_type half = _length / 2;
+            block_type const* roots = _roots.data() + half;
+
+            Parallel::forEach(
+                    0
+                ,   half
+                ,   [&]( size_type _begin, size_type _end )
+                    {
+                        for( size_type count = _begin; count < _end; ++count )
+                        {
+                            block_type left = _data[count];
+                            block_type right = _data[half + count];
+
+                            _data[count] = _field.add( left, right );
+                            _data[half + count] = _field.multiply(
+                                    _field.subtract( left, right )
+                                ,   roots[count]
+                            );
+                        }
+                    }
+            );
+
+            Parallel::TaskGroup group;
+            group.run( [&]{ forwardTransform( _field, _data + half, half, _roots ); } );
+            forwardTransform( _field, _data, half, _roots );
+            group.wait();
+
+            return;
+        }
+
+        for( size_type half = _length / 2; half; half /= 2 )
+            for( size_type start = 0; start < _length; start += 2 * half )
+            {
+                block_type* low = _data + start;
+                block_type* high = low + half;
+                block_type const* roots = _roots.data() + half;
+
+                for( size_type count = 0; count < half; ++count )
+                {
+                    block_type left = low[count];
+                    block_type right = high[count];
+
+                    low[count] = _field.add( left, right );
+                    high[count] = _field.multiply( _field.subtract( left, right ), roots[count] );
+                }
+            }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // decimation in time, bit-reversed order in, natural order out, unscaled;
+    // long transforms are split the same way as the forward ones
+    void
+    inverseTransform(
+            PrimeField const& _field
+        ,   block_type * _data
+        ,   size_type _length
+        ,   std::vector< block_type > const& _roots
+    )
+    {
+        if( Parallel::isWorthSplitting( _length ) )
+        {
+            size_type half = _length / 2;
+            block_type const* roots = _roots.data() + half;
+
+            Parallel::TaskGroup group;
+            group.run( [&]{ inverseTransform( _field, _data + half, half, _roots ); } );
+            inverseTransform( _field, _data, half, _roots );
+            group.wait();
+
+            Parallel::forEach(
+                    0
+                ,   half
+                ,   [&]( size_type _begin, size_type _end )
+                    {
+                        for( size_type count = _begin; count < _end; ++count )
+                        {
+                            block_type left = _data[count];
+                            block_type right = _field.multiply( _data[half + count], roots[count] );
+
+                            _data[count] = _field.add( left, right );
+                            _data[half + count] = _field.subtract( left, right );
+                        }
+                    }
+            );
+
+            return;
+        }
+
+        for( size_type half = 1; half < _length; half *= 2 )
+            for( size_type start = 0; start < _length; start += 2 * half )
+            {
+                block_type* low = _data + start;
+                block_type* high = low + half;
+                block_type const* roots = _roots.data() + half;
+
+                for( size_type count = 0; count < half; ++count )
+                {
+                    block_type left = low[count];
+                    block_type right = _field.multiply( high[count], roots[count] );
+
+                    low[count] = _field.add( left, right );
+                    high[count] = _field.subtract( left, right );
+                }
+            }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // pointwise products carry an extra 1 / R, the final scaling by
+    // R / _length brings the inverse transform back to plain residues
+    void
+    finishProduct(
+            size_type _index
+        ,   block_type * _data
+        ,   size_type _length
+    )
+    {
+        PrimeField const& primeField = field( _index );
+
+        inverseTransform( primeField, _data, _length, *rootsTable( _index, _length, true ) );
+
+        block_type lengthInverse = primeField.power(
+                primeField.toMontgomery( _length )
+            ,   primeField.modulus() - 2
+        );
+        block_type scale = primeField.toMontgomery( lengthInverse );
+
+        Parallel::forEach(
+                0
+            ,   _length
+            ,   [&]( size_type _begin, size_type _end )
+                {
+                    for( size_type count = _begin; count < _end; ++count )
+                        _data[count] = primeField.multiply( _data[count], scale );
+                }
+        );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // restores the exact convolution from its residues, _length of them
+    // for every prime one after another, and releases carries
+    void
+    combineResidues(
+            block_type * _result
+        ,   size_type _resultSize
+        ,   block_type const* _residues
+        ,   size_type _length
+        ,   std::pmr::memory_resource * _resource
+    )
+    {
+        PrimeField const& second = field( 1 );
+        PrimeField const& third  = field( 2 );
+
+        block_type firstModulus = field( 0 ).modulus();
+
+        block_type firstInverse = second.power(
+                second.toMontgomery( firstModulus )
+            ,   second.modulus() - 2
+        );
+        block_type firstByThird = third.toMontgomery( firstModulus );
+        block_type productInverse = third.multiply(
+                third.power( third.toMontgomery( firstModulus ), third.modulus() - 2 )
+            ,   third.power( third.toMontgomery( second.modulus() ), third.modulus() - 2 )
+        );
+
+        block_type productHigh;
+        block_type productLow = BlockArithmetic::mulWide( firstModulus, second.modulus(), productHigh );
+
+        size_type coefficients = std::min( _resultSize, _length );
+
+        block_type const* firstResidues = _residues;
+        block_type const* secondResidues = _residues + _length;
+        block_type const* thirdResidues = _residues + 2 * _length;
+
+        // converts [_begin, _end) starting from a zero carry, leaves in
+        // _carry what goes into the two blocks above
+        auto combine = [&]( size_type _begin, size_type _end, block_type * _carry )
+        {
+            for( size_type count = _begin; count < _end; ++count )
+            {
+                block_type value[3] = { 0, 0, 0 };
+
+                if( count < coefficients )
+                {
+                    // Garner's mixed radix digits of the coefficient
+                    block_type digit0 = firstResidues[count];
+                    block_type digit1 = second.multiply(
+                            second.subtract( secondResidues[count], second.reduce( digit0 ) )
+                        ,   firstInverse
+                    );
+                    block_type digit2 = third.subtract( thirdResidues[count], third.reduce( digit0 ) );
+                    digit2 = third.subtract( digit2, third.multiply( third.reduce( digit1 ), firstByThird ) );
+                    digit2 = third.multiply( digit2, productInverse );
+
+                    block_type high;
+                    value[0] = BlockArithmetic::mulWide( digit1, firstModulus, value[1] );
+                    value[0] += digit0;
+                    value[1] += value[0] < digit0;
+
+                    block_type part[3];
+                    part[0] = BlockArithmetic::mulWide( digit2, productLow, part[1] );
+                    block_type middle = BlockArithmetic::mulWide( digit2, productHigh, high );
+                    part[1] += middle;
+                    part[2] = high + ( part[1] < middle );
+
+                    BlockArithmetic::addBlocks( value, value, 3, part, 3 );
+                }
+
+                BlockArithmetic::addBlocks( value, value, 3, _carry, 2 );
+
+                _result[count] = value[0];
+                _carry[0] = value[1];
+                _carry[1] = value[2];
+            }
+        };
+
+        if( !Parallel::isWorthSplitting( _resultSize ) )
+        {
+            block_type carry[2] = { 0, 0 };
+            combine( 0, _resultSize, carry );
+
+            return;
+        }
+
+        // pieces in parallel, then their carries in order
+        size_type pieces = std::min( _resultSize / Parallel::getGrain(), 4 * Parallel::getThreads() );
+        std::pmr::vector< block_type > carries( 2 * pieces, 0, _resource );
+
+        auto begin = [&]( size_type _piece ){ return _resultSize * _piece / pieces; };
+
+        Parallel::TaskGroup group;
+        for( size_type piece = 1; piece < pieces; ++piece )
+            group.run( [&, piece]{ combine( begin( piece ), begin( piece + 1 ), carries.data() + 2 * piece ); } );
+
+        combine( 0, begin( 1 ), carries.data() );
+        group.wait();
+
+        for( size_type piece = 1; piece < pieces; ++piece )
+        {
+            size_type start = begin( piece );
+            block_type const* carry = carries.data() + 2 * ( piece - 1 );
+
+            BlockArithmetic::incrementBlocks( _result + start, _resultSize - start, carry[0] );
+            BlockArithmetic::incrementBlocks( _result + start + 1, _resultSize - start - 1, carry[1] );
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _body( index ) for every prime, concurrently for long transforms
+    void
+    forEachPrime( size_type _length, std::function< void( size_type ) > const& _body )
+    {
+        if( !Parallel::isWorthSplitting( _length ) )
+        {
+            for( size_type index = 0; index < PrimesCount; ++index )
+                _body( index );
+
+            return;
+        }
+
+        Parallel::TaskGroup group;
+        for( size_type index = 1; index < PrimesCount; ++index )
+            group.run( [&, index]{ _body( index ); } );
+
+        _body( 0 );
+        group.wait();
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+transformLength( size_type _size ) noexcept
+{
+    size_type length = 1;
+    while( length < _size )
+        length *= 2;
+
+    return length;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Spectrum::Spectrum(
+        block_type const* _data
+    ,   size_type _size
+    ,   size_type _length
+    ,   std::pmr::memory_resource * _resource
+)
+    :   m_values( PrimesCount * _length, _resource )
+    ,   m_length{ _length }
+    ,   m_factorSize{ _size }
+{
+    forEachPrime(
+            m_length
+        ,   [&]( size_type _index )
+            {
+                PrimeField const& primeField = field( _index );
+                block_type* values = m_values.data() + _index * m_length;
+
+                for( size_type count = 0; count < _size; ++count )
+                    values[count] = primeField.reduce( _data[count] );
+
+                forwardTransform( primeField, values, m_length, *rootsTable( _index, m_length, false ) );
+            }
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Spectrum::length() const noexcept
+{
+    return m_length;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Spectrum::factorSize() const noexcept
+{
+    return m_factorSize;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Spectrum::multiply(
+        block_type * _result
+    ,   block_type const* _other
+    ,   size_type _otherSize
+    ,   std::pmr::memory_resource * _resource
+) const
+{
+    std::pmr::vector< block_type > residues( PrimesCount * m_length, _resource );
+
+    forEachPrime(
+            m_length
+        ,   [&]( size_type _index )
+            {
+                PrimeField const& primeField = field( _index );
+                block_type* values = residues.data() + _index * m_length;
+                block_type const* factor = m_values.data() + _index * m_length;
+
+                for( size_type count = 0; count < _otherSize; ++count )
+                    values[count] = primeField.reduce( _other[count] );
+
+                forwardTransform( primeField, values, m_length, *rootsTable( _index, m_length, false ) );
+
+                Parallel::forEach(
+                        0
+                    ,   m_length
+                    ,   [&]( size_type _begin, size_type _end )
+                        {
+                            for( size_type count = _begin; count < _end; ++count )
+                                values[count] = primeField.multiply( values[count], factor[count] );
+                        }
+                );
+
+                finishProduct( _index, values, m_length );
+            }
+    );
+
+    combineResidues( _result, m_factorSize + _otherSize, residues.data(), m_length, _resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Spectrum::square( block_type * _result, std::pmr::memory_resource * _resource ) const
+{
+    std::pmr::vector< block_type > residues( PrimesCount * m_length, _resource );
+
+    forEachPrime(
+            m_length
+        ,   [&]( size_type _index )
+            {
+                PrimeField const& primeField = field( _index );
+                block_type* values = residues.data() + _index * m_length;
+                block_type const* factor = m_values.data() + _index * m_length;
+
+                Parallel::forEach(
+                        0
+                    ,   m_length
+                    ,   [&]( size_type _begin, size_type _end )
+                        {
+                            for( size_type count = _begin; count < _end; ++count )
+                                values[count] = primeField.multiply( factor[count], factor[count] );
+                        }
+                );
+
+                finishProduct( _index, values, m_length );
+            }
+    );
+
+    combineResidues( _result, 2 * m_factorSize, residues.data(), m_length, _resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+multiply(
+        block_type * _result
+    ,   block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    Spectrum spectrum( _left, _leftSize, transformLength( _leftSize + _rightSize ), _resource );
+    spectrum.multiply( _result, _right, _rightSize, _resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+square(
+        block_type * _result
+    ,   block_type const* _data
+    ,   size_type _size
+    ,   std::pmr::memory_resource * _resource
+)
+{
+    Spectrum spectrum( _data, _size, transformLength( 2 * _size ), _resource );
+    spectrum.square( _result, _resource );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Ntt
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,126 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_NTT_HPP_
+#define BIG_INTEGER_NTT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "block_arithmetic.hpp"
+
+#include <memory_resource>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Size of the shorter factor (in blocks) from which multiplication goes
+*  through the number-theoretic transform. Can be overridden from the
+*  compiler command line.
+*/
+
+#ifndef BIG_INTEGER_NTT_THRESHOLD
+#define BIG_INTEGER_NTT_THRESHOLD 1536
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Exact multiplication through number-theoretic transforms modulo three
+*  primes below 2^62. Every block is a single coefficient, the convolution
+*  is recovered with the chinese remainder theorem, which stays exact while
+*  the transform length is below 2^40.
+*/
+
+namespace Ntt {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+    constexpr size_type Threshold = BIG_INTEGER_NTT_THRESHOLD;
+
+    constexpr size_type PrimesCount = 3;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // smallest supported transform length holding a product of _size blocks
+    size_type transformLength( size_type _size ) noexcept;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // forward transforms of one factor, reusable for any other factor
+    // as long as the product fits into the transform length; the
+    // transforms and the scratch of every product come from the given
+    // resources, all of it allocated before any task starts
+    class Spectrum
+    {
+        public:
+
+            Spectrum(
+                    block_type const* _data
+                ,   size_type _size
+                ,   size_type _length
+                ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+            );
+
+            /*-----------------------------------------------------------------------*/
+
+            size_type length() const noexcept;
+
+            size_type factorSize() const noexcept;
+
+            /*-----------------------------------------------------------------------*/
+
+            // _result[0, factorSize() + _otherSize) = factor * _other
+            void multiply(
+                    block_type * _result
+                ,   block_type const* _other
+                ,   size_type _otherSize
+                ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+            ) const;
+
+            // _result[0, 2 * factorSize()) = factor * factor
+            void square(
+                    block_type * _result
+                ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+            ) const;
+
+        private:
+
+            // the transforms for every prime one after another, m_length each
+            std::pmr::vector< block_type > m_values;
+
+            size_type m_length;
+
+            size_type m_factorSize;
+
+    }; // class Spectrum
+
+/*-----------------------------------------------------------------------------------*/
+
+    void multiply(
+            block_type * _result
+        ,   block_type const* _left
+        ,   size_type _leftSize
+        ,   block_type const* _right
+        ,   size_type _rightSize
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+    void square(
+            block_type * _result
+        ,   block_type const* _data
+        ,   size_type _size
+        ,   std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Ntt
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_NTT_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,420 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Parallel {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using Task = std::function< void() >;
+
+/*-----------------------------------------------------------------------------------*/
+
+    class Pool
+    {
+        public:
+
+            explicit Pool( size_type _workers )
+                :   m_queued{ 0 }
+                ,   m_stop{ false }
+            {
+                // queue 0 takes the tasks of threads outside the pool
+                for( size_type index = 0; index <= _workers; ++index )
+                    m_queues.push_back( std::make_unique< Queue >() );
+
+                for( size_type index = 1; index <= _workers; ++index )
+                    m_threads.emplace_back( [this, index]{ work( index ); } );
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            ~Pool()
+            {
+                {
+                    std::lock_guard< std::mutex > lock( m_sleepMutex );
+                    m_stop = true;
+                }
+
+                m_wake.notify_all();
+
+                for( std::thread& thread : m_threads )
+                    thread.join();
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            void submit( Task _task )
+            {
+                Queue& queue = *m_queues[ownQueue()];
+
+                {
+                    std::lock_guard< std::mutex > lock( queue.m_mutex );
+                    queue.m_tasks.push_back( std::move( _task ) );
+                }
+
+                m_queued.fetch_add( 1, std::memory_order_release );
+
+                // a worker checks m_queued under this mutex before sleeping
+                {
+                    std::lock_guard< std::mutex > lock( m_sleepMutex );
+                }
+
+                m_wake.notify_one();
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // runs one queued task, false when there is none
+            bool runOne()
+            {
+                Task task;
+                if( !take( ownQueue(), task ) )
+                    return false;
+
+                task();
+                return true;
+            }
+
+        private:
+
+            struct Queue
+            {
+                std::mutex m_mutex;
+
+                std::deque< Task > m_tasks;
+            };
+
+            /*-----------------------------------------------------------------------*/
+
+            size_type ownQueue() const noexcept
+            {
+                return s_pool == this ? s_queue : 0;
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            // newest task of the own queue, or oldest of another one
+            bool take( size_type _queue, Task & _task )
+            {
+                if( !m_queued.load( std::memory_order_acquire ) )
+                    return false;
+
+                size_type count = m_queues.size();
+
+                for( size_type step = 0; step < count; ++step )
+                {
+                    Queue& queue = *m_queues[( _queue + step ) % count];
+                    std::lock_guard< std::mutex > lock( queue.m_mutex );
+
+                    if( queue.m_tasks.empty() )
+                        continue;
+
+                    if( step )
+                    {
+                        _task = std::move( queue.m_tasks.front() );
+                        queue.m_tasks.pop_front();
+                    }
+                    else
+                    {
+                        _task = std::move( queue.m_tasks.back() );
+                        queue.m_tasks.pop_back();
+                    }
+
+                    m_queued.fetch_sub( 1, std::memory_order_relaxed );
+                    return true;
+                }
+
+                return false;
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            void work( size_type _queue )
+            {
+                s_pool = this;
+                s_queue = _queue;
+
+                for( ;; )
+                {
+                    if( runOne() )
+                        continue;
+
+                    std::unique_lock< std::mutex > lock( m_sleepMutex );
+                    m_wake.wait( lock, [this]{ return m_stop || m_queued.load(); } );
+
+                    if( m_stop )
+                        return;
+                }
+            }
+
+            /*-----------------------------------------------------------------------*/
+
+            std::vector< std::unique_ptr< Queue > > m_queues;
+
+            std::vector< std::thread > m_threads;
+
+            std::atomic< size_type > m_queued;
+
+            std::mutex m_sleepMutex;
+
+            std::condition_variable m_wake;
+
+            bool m_stop;
+
+            static thread_local Pool const* s_pool;
+
+            static thread_local size_type s_queue;
+
+    }; // class Pool
+
+    thread_local Pool const* Pool::s_pool = nullptr;
+
+    thread_local size_type Pool::s_queue = 0;
+
+/*-----------------------------------------------------------------------------------*/
+
+    std::atomic< size_type > g_threads{ 1 };
+
+    std::atomic< size_type > g_grain{ DefaultGrain };
+
+    std::unique_ptr< Pool > g_pool;
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+setThreads( size_type _threads )
+{
+    if( !_threads )
+        _threads = std::max( std::thread::hardware_concurrency(), 1u );
+
+    if( _threads == g_threads )
+        return;
+
+    g_pool.reset();
+    if( _threads > 1 )
+        g_pool = std::make_unique< Pool >( _threads - 1 );
+
+    g_threads = _threads;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+getThreads() noexcept
+{
+    return g_threads;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+setGrain( size_type _grain ) noexcept
+{
+    g_grain = std::max< size_type >( _grain, 1 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+getGrain() noexcept
+{
+    return g_grain;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+isWorthSplitting( size_type _size ) noexcept
+{
+    return g_threads > 1 && _size >= g_grain;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+SharedResource::SharedResource( std::pmr::memory_resource * _upstream ) noexcept
+    :   m_upstream{ _upstream }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+std::pmr::memory_resource*
+SharedResource::get() noexcept
+{
+    if( g_threads <= 1 || m_upstream == std::pmr::new_delete_resource() )
+        return m_upstream;
+
+    return this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void*
+SharedResource::do_allocate( size_type _bytes, size_type _alignment )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return m_upstream->allocate( _bytes, _alignment );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+SharedResource::do_deallocate( void* _pointer, size_type _bytes, size_type _alignment )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_upstream->deallocate( _pointer, _bytes, _alignment );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+SharedResource::do_is_equal( std::pmr::memory_resource const& _other ) const noexcept
+{
+    return this == &_other;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+TaskGroup::TaskGroup() noexcept
+    :   m_pending{ 0 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        wait();
+    }
+    catch( ... )
+    {
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+TaskGroup::run( std::function< void() > _task )
+{
+    if( !g_pool )
+    {
+        try
+        {
+            _task();
+        }
+        catch( ... )
+        {
+            finish( std::current_exception() );
+        }
+
+        return;
+    }
+
+    ++m_pending;
+
+    g_pool->submit(
+        [this, task = std::move( _task )]
+        {
+            std::exception_ptr error;
+
+            try
+            {
+                task();
+            }
+            catch( ... )
+            {
+                error = std::current_exception();
+            }
+
+            finish( error );
+            --m_pending;
+        }
+    );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+TaskGroup::wait()
+{
+    while( m_pending )
+        if( !g_pool->runOne() )
+            std::this_thread::yield();
+
+    std::exception_ptr error;
+    std::swap( error, m_error );
+
+    if( error )
+        std::rethrow_exception( error );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+TaskGroup::finish( std::exception_ptr _error ) noexcept
+{
+    if( !_error )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_errorMutex );
+    if( !m_error )
+        m_error = _error;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+forEach(
+        size_type _begin
+    ,   size_type _end
+    ,   std::function< void( size_type, size_type ) > const& _body
+)
+{
+    size_type size = _end - _begin;
+    size_type grain = g_grain;
+
+    if( !isWorthSplitting( size ) || size < 2 * grain )
+    {
+        _body( _begin, _end );
+        return;
+    }
+
+    // a few pieces per thread even out the differences in speed
+    size_type pieces = std::min( size / grain, 4 * g_threads );
+
+    TaskGroup group;
+
+    for( size_type piece = 1; piece < pieces; ++piece )
+        group.run( [&, piece]{ _body( _begin + size * piece / pieces, _begin + size * ( piece + 1 ) / pieces ); } );
+
+    _body( _begin, _begin + size / pieces );
+
+    group.wait();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Parallel
+
+/*-----------------------------------------------------------------------------------*/
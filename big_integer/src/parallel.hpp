@@ -0,0 +1,154 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_PARALLEL_HPP_
+#define BIG_INTEGER_PARALLEL_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Smallest piece of work (in blocks of an operand or points of a
+*  transform) the multiplication hands to another thread. Can be
+*  overridden from the compiler command line or with Parallel::setGrain().
+*/
+
+#ifndef BIG_INTEGER_PARALLEL_GRAIN
+#define BIG_INTEGER_PARALLEL_GRAIN 2048
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Work-stealing thread pool used by the multiplication of large operands.
+*  Every worker keeps its own deque of tasks, runs them newest first and
+*  steals the oldest ones of the others when it runs dry; a thread waiting
+*  for a group of tasks keeps executing tasks meanwhile, so nested
+*  parallel sections never block each other.
+*
+*  Multiplication stays on the calling thread until setThreads() allows
+*  more.
+*/
+
+namespace Parallel {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using size_type = std::size_t;
+
+    constexpr size_type DefaultGrain = BIG_INTEGER_PARALLEL_GRAIN;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // threads working on one multiplication, the calling one included;
+    // 1 disables the pool, 0 stands for the number of cores. Must not be
+    // changed while a multiplication is running
+    void setThreads( size_type _threads );
+
+    size_type getThreads() noexcept;
+
+    void setGrain( size_type _grain ) noexcept;
+
+    size_type getGrain() noexcept;
+
+    // whether work of _size blocks or points is worth splitting
+    bool isWorthSplitting( size_type _size ) noexcept;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // tasks that may run on other threads and are waited for together
+    class TaskGroup
+    {
+        public:
+
+            TaskGroup() noexcept;
+
+            TaskGroup( TaskGroup const& ) = delete;
+
+            TaskGroup& operator = ( TaskGroup const& ) = delete;
+
+            // waits for the tasks still running, their exceptions are lost
+            ~TaskGroup();
+
+            /*-----------------------------------------------------------------------*/
+
+            // runs _task right away when the pool is disabled
+            void run( std::function< void() > _task );
+
+            // runs queued tasks until all of the group are done, then
+            // rethrows the first exception one of them threw
+            void wait();
+
+        private:
+
+            void finish( std::exception_ptr _error ) noexcept;
+
+            /*-----------------------------------------------------------------------*/
+
+            std::atomic< size_type > m_pending;
+
+            std::mutex m_errorMutex;
+
+            std::exception_ptr m_error;
+
+    }; // class TaskGroup
+
+/*-----------------------------------------------------------------------------------*/
+
+    // hands the allocations of all threads to an upstream resource one at
+    // a time, so that the tasks of a parallel operation can take their
+    // scratch from a resource that is not thread safe, such as an Arena
+    class SharedResource
+        :   public std::pmr::memory_resource
+    {
+        public:
+
+            explicit SharedResource( std::pmr::memory_resource * _upstream ) noexcept;
+
+            /*-----------------------------------------------------------------------*/
+
+            // the resource for the tasks: the upstream one itself when no
+            // other thread can run them or it is the thread-safe global heap
+            std::pmr::memory_resource* get() noexcept;
+
+        private:
+
+            void* do_allocate( size_type _bytes, size_type _alignment ) override;
+
+            void do_deallocate( void* _pointer, size_type _bytes, size_type _alignment ) override;
+
+            bool do_is_equal( std::pmr::memory_resource const& _other ) const noexcept override;
+
+            /*-----------------------------------------------------------------------*/
+
+            std::pmr::memory_resource* m_upstream;
+
+            std::mutex m_mutex;
+
+    }; // class SharedResource
+
+/*-----------------------------------------------------------------------------------*/
+
+    // _body on consecutive subranges of [_begin, _end) of about the grain
+    void forEach(
+            size_type _begin
+        ,   size_type _end
+        ,   std::function< void( size_type, size_type ) > const& _body
+    );
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Parallel
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_PARALLEL_HPP_
+
+/*-----------------------------------------------------------------------------------*/
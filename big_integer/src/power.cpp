@@ -0,0 +1,369 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "power.hpp"
+#include "messages.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/*-----------------------------------------------------------------------------------*/
+
+class Powers
+{
+    public:
+
+        using size_type = BigInteger::size_type;
+        using block_type = BigInteger::block_type;
+
+        /*---------------------------------------------------------------------------*/
+
+        static BigInteger power( BigInteger const& _base, size_type _exponent );
+
+        static BigInteger root( BigInteger const& _value, size_type _degree );
+
+    private:
+
+        static constexpr size_type SmallSquareRoot = 4;
+
+        /*---------------------------------------------------------------------------*/
+
+        // the square root of a value of at least 4
+        static BigInteger squareRoot( BigInteger const& _value );
+
+        // Zimmermann's Karatsuba square root with remainder: the root of
+        // the upper half and one division of a quarter by it give the rest.
+        // _value takes an even number of blocks, the top one at least 2^62
+        static void squareRoot(
+                BigInteger const& _value
+            ,   BigInteger & _root
+            ,   BigInteger & _remainder
+        );
+
+        // ( ( degree - 1 ) * x + value / x ^ ( degree - 1 ) ) / degree, never
+        // below the root whatever x is
+        static BigInteger newtonStep(
+                BigInteger const& _value
+            ,   size_type _degree
+            ,   BigInteger const& _estimate
+        );
+
+        // the root of a value too short to be split, iterated from the
+        // floating-point estimate
+        static BigInteger smallRoot( BigInteger const& _value, size_type _degree );
+
+        // a little above the root, correct to about 30 bits
+        static BigInteger estimate( BigInteger const& _value, size_type _degree );
+
+        static size_type bitLength( BigInteger const& _value ) noexcept;
+
+        static BigInteger powerOfTwo( size_type _exponent );
+
+        // the blocks of _value in [_begin, _end)
+        static BigInteger slice( BigInteger const& _value, size_type _begin, size_type _end );
+
+        // _value * 2^( 64 * _blocks )
+        static BigInteger shifted( BigInteger const& _value, size_type _blocks );
+
+}; // class Powers
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::power( BigInteger const& _base, size_type _exponent )
+{
+    if( !_exponent )
+        return 1_b;
+
+    BigInteger result = _base;
+    BigInteger scratch;
+
+    size_type bit = BlockArithmetic::BlockBits - 1 - BlockArithmetic::countLeadingZeros( _exponent );
+
+    // the products go to the scratch object and are swapped in, so that
+    // the two buffers serve all the steps
+    while( bit-- > 0 )
+    {
+        scratch.assignProduct( result, result );
+        std::swap( result, scratch );
+
+        if( !( ( _exponent >> bit ) & 1 ) )
+            continue;
+
+        if( _base.m_size == 1 )
+            result *= _base.m_pData[0];
+        else
+        {
+            scratch.assignProduct( result, _base );
+            std::swap( result, scratch );
+        }
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::root( BigInteger const& _value, size_type _degree )
+{
+    if( !_degree )
+        throw std::logic_error( Messages::ZeroDegree );
+
+    size_type bits = bitLength( _value );
+
+    if( _degree == 1 || !bits )
+        return _value;
+
+    // 1 <= value < 2^degree
+    if( _degree >= bits )
+        return 1_b;
+
+    if( _degree == 2 )
+        return squareRoot( _value );
+
+    // the value without its lower degree * shift blocks has a root s of
+    // at least shift + 2 blocks; the root of the value lies less than
+    // 2^( 64 * shift ) below ( s + 1 ) * 2^( 64 * shift ), close enough
+    // for a Newton step from there to land on it or just above
+    size_type size = _value.m_size;
+
+    if( size <= 4 * _degree + 1 )
+        return smallRoot( _value, _degree );
+
+    size_type shift = ( size - 1 - 2 * _degree ) / ( 2 * _degree );
+
+    BigInteger start = root( slice( _value, _degree * shift, size ), _degree );
+    start += 1;
+
+    BigInteger result = newtonStep( _value, _degree, shifted( start, shift ) );
+
+    while( power( result, _degree ) > _value )
+        result -= 1;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::squareRoot( BigInteger const& _value )
+{
+    size_type size = _value.m_size;
+
+    if( size <= SmallSquareRoot )
+        return smallRoot( _value, 2 );
+
+    // value * 4^shift, of an even number of blocks with the top one
+    // normalized; a block added below counts as 4^32
+    size_type odd = size % 2;
+    unsigned shift = BlockArithmetic::countLeadingZeros( _value.m_pData[size - 1] ) / 2;
+
+    BigInteger normalized;
+    block_type* blocks = normalized.allocate( size + odd );
+
+    blocks[0] = 0;
+    BlockArithmetic::shiftLeft( blocks + odd, _value.m_pData, size, 2 * shift );
+    normalized.m_size = size + odd;
+
+    BigInteger root;
+    BigInteger remainder;
+    squareRoot( normalized, root, remainder );
+
+    shift += 32 * odd;
+
+    BigInteger result;
+    blocks = result.allocate( root.m_size );
+
+    BlockArithmetic::shiftRight( blocks, root.m_pData, root.m_size, shift );
+    result.m_size = root.m_size;
+    result.normalize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Powers::squareRoot( BigInteger const& _value, BigInteger & _root, BigInteger & _remainder )
+{
+    size_type size = _value.m_size;
+
+    if( size <= SmallSquareRoot )
+    {
+        _root = smallRoot( _value, 2 );
+        _remainder = _value - _root * _root;
+        return;
+    }
+
+    // value = high * b^2 + middle * b + low with b = 2^( 64 * quarter )
+    size_type quarter = size / 4;
+
+    BigInteger root;
+    BigInteger remainder;
+    squareRoot( slice( _value, 2 * quarter, size ), root, remainder );
+
+    BigInteger numerator = shifted( remainder, quarter ) + slice( _value, quarter, 2 * quarter );
+    auto [quotient, rest] = divmod( numerator, root * size_type( 2 ) );
+
+    _root = shifted( root, quarter ) + quotient;
+    _remainder = shifted( rest, quarter ) + slice( _value, 0, quarter );
+
+    // one correction at most when the remainder comes out negative
+    BigInteger square = quotient * quotient;
+
+    if( _remainder < square )
+    {
+        _remainder += _root * size_type( 2 );
+        _remainder -= 1;
+        _root -= 1;
+    }
+
+    _remainder -= square;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::newtonStep( BigInteger const& _value, size_type _degree, BigInteger const& _estimate )
+{
+    BigInteger result = _value / power( _estimate, _degree - 1 );
+
+    result += _estimate * ( _degree - 1 );
+    result /= _degree;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::smallRoot( BigInteger const& _value, size_type _degree )
+{
+    // from above the iteration decreases until it reaches the root
+    BigInteger result = estimate( _value, _degree );
+
+    for( ;; )
+    {
+        BigInteger next = newtonStep( _value, _degree, result );
+
+        if( next >= result )
+            return result;
+
+        result = std::move( next );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::estimate( BigInteger const& _value, size_type _degree )
+{
+    size_type bits = bitLength( _value );
+    size_type dropped = bits > BlockArithmetic::BlockBits ? bits - BlockArithmetic::BlockBits : 0;
+
+    size_type index = dropped / BlockArithmetic::BlockBits;
+    unsigned offset = dropped % BlockArithmetic::BlockBits;
+
+    block_type leading = _value.m_pData[index] >> offset;
+    if( offset )
+        leading |= _value.m_pData[index + 1] << ( BlockArithmetic::BlockBits - offset );
+
+    double exponent = ( dropped + std::log2( double( leading ) ) ) / _degree;
+
+    // mantissa * 2^scale with a mantissa of at most 54 bits
+    size_type scale = exponent > 52 ? size_type( exponent ) - 52 : 0;
+
+    block_type mantissa = block_type( std::exp2( exponent - scale ) * ( 1 + std::exp2( -30 ) ) ) + 1;
+
+    BigInteger result = powerOfTwo( scale );
+    result *= mantissa;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Powers::size_type
+Powers::bitLength( BigInteger const& _value ) noexcept
+{
+    if( !_value.m_size )
+        return 0;
+
+    return _value.m_size * BlockArithmetic::BlockBits
+        -   BlockArithmetic::countLeadingZeros( _value.m_pData[_value.m_size - 1] );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::powerOfTwo( size_type _exponent )
+{
+    BigInteger result;
+
+    size_type size = _exponent / BlockArithmetic::BlockBits + 1;
+    block_type* blocks = result.allocate( size );
+
+    std::fill_n( blocks, size - 1, 0 );
+    blocks[size - 1] = block_type( 1 ) << ( _exponent % BlockArithmetic::BlockBits );
+    result.m_size = size;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::slice( BigInteger const& _value, size_type _begin, size_type _end )
+{
+    _end = std::min( _end, _value.m_size );
+
+    if( _end <= _begin )
+        return BigInteger();
+
+    return BigInteger::fromBlocks( _value.m_pData + _begin, _end - _begin );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+Powers::shifted( BigInteger const& _value, size_type _blocks )
+{
+    BigInteger result;
+
+    if( !_value.m_size )
+        return result;
+
+    block_type* blocks = result.allocate( _value.m_size + _blocks );
+
+    std::fill_n( blocks, _blocks, 0 );
+    std::copy_n( _value.m_pData, _value.m_size, blocks + _blocks );
+    result.m_size = _value.m_size + _blocks;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+pow( BigInteger const& _base, BigInteger::size_type _exponent )
+{
+    return Powers::power( _base, _exponent );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+isqrt( BigInteger const& _value )
+{
+    return Powers::root( _value, 2 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BigInteger
+iroot( BigInteger const& _value, BigInteger::size_type _degree )
+{
+    return Powers::root( _value, _degree );
+}
+
+/*-----------------------------------------------------------------------------------*/
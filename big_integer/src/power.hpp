@@ -0,0 +1,29 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_POWER_HPP_
+#define BIG_INTEGER_POWER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "biginteger.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+// _base ^ _exponent by left-to-right binary exponentiation, a squaring for
+// every bit of the exponent; 0 ^ 0 = 1
+BigInteger pow( BigInteger const& _base, BigInteger::size_type _exponent );
+
+// the largest r with r * r <= _value
+BigInteger isqrt( BigInteger const& _value );
+
+// the largest r with r ^ _degree <= _value; Newton's iteration from the
+// root of the upper half of the blocks, so that the precision doubles
+// with every level and the last one costs a few full multiplications.
+// Throws std::logic_error for _degree 0
+BigInteger iroot( BigInteger const& _value, BigInteger::size_type _degree );
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_POWER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
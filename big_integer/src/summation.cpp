@@ -0,0 +1,85 @@
+/** (C) 2017 Ivan Semenenko */
+
+#include "summation.hpp"
+#include "multiplication.hpp"
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Summation {
+
+/*-----------------------------------------------------------------------------------*/
+
+Accumulator::Accumulator( std::pmr::memory_resource * _resource )
+    :   m_sums( _resource )
+    ,   m_carries( _resource )
+    ,   m_product( _resource )
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Accumulator::grow( size_type _size )
+{
+    m_sums.resize( _size, 0 );
+    m_carries.resize( _size + 1, 0 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Accumulator::addProduct(
+        block_type const* _left
+    ,   size_type _leftSize
+    ,   block_type const* _right
+    ,   size_type _rightSize
+)
+{
+    if( !_leftSize || !_rightSize )
+        return;
+
+    size_type size = _leftSize + _rightSize;
+    m_product.resize( size );
+
+    std::pmr::memory_resource* resource = m_product.get_allocator().resource();
+
+    if( _left == _right && _leftSize == _rightSize )
+        Multiplication::square( m_product.data(), _left, _leftSize, resource );
+    else
+        Multiplication::multiply( m_product.data(), _left, _leftSize, _right, _rightSize, resource );
+
+    add( m_product.data(), BlockArithmetic::normalizedSize( m_product.data(), size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Accumulator::resultSize() const noexcept
+{
+    return m_carries.size() + 1;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Accumulator::finish( block_type * _result ) const
+{
+    size_type size = m_carries.size();
+    if( !size )
+        return 0;
+
+    std::copy( m_sums.begin(), m_sums.end(), _result );
+    _result[size - 1] = 0;
+    _result[size] = 0;
+
+    // every carry count is below 2^64, so one block per position suffices
+    _result[size] = CarryKernels::addBlocks( _result, _result, size, m_carries.data(), size );
+
+    return BlockArithmetic::normalizedSize( _result, size + 1 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Summation
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,108 @@
+/** (C) 2017 Ivan Semenenko */
+
+#ifndef BIG_INTEGER_SUMMATION_HPP_
+#define BIG_INTEGER_SUMMATION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "carry_kernels.hpp"
+
+#include <memory_resource>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Summation {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BlockArithmetic::block_type;
+    using BlockArithmetic::size_type;
+
+/*-----------------------------------------------------------------------------------*/
+
+    /*
+    *  Accumulator with deferred carries. Adding a value never propagates a
+    *  carry past the value's own blocks; carries are counted per position
+    *  instead and added in once, by finish(). Its buffers and the scratch
+    *  of the products come from the given resource.
+    */
+
+    class Accumulator
+    {
+        public:
+
+            static constexpr size_type ShortValue = 4;
+
+            explicit Accumulator(
+                std::pmr::memory_resource * _resource = std::pmr::get_default_resource()
+            );
+
+            void add( block_type const* _data, size_type _size )
+            {
+                if( !_size )
+                    return;
+
+                if( _size > m_sums.size() )
+                    grow( _size );
+
+                // short values skip the kernel call, every block counts its
+                // own carry; longer ones run the carry chain over their
+                // blocks and count only the carry out of the top one
+                if( _size < ShortValue )
+                {
+                    for( size_type index = 0; index < _size; ++index )
+                    {
+                        block_type sum = m_sums[index] + _data[index];
+
+                        m_carries[index + 1] += sum < _data[index];
+                        m_sums[index] = sum;
+                    }
+                }
+                else
+                    m_carries[_size] += CarryKernels::addBlocks(
+                            m_sums.data()
+                        ,   m_sums.data()
+                        ,   _size
+                        ,   _data
+                        ,   _size
+                    );
+            }
+
+            // adds _left * _right
+            void addProduct(
+                    block_type const* _left
+                ,   size_type _leftSize
+                ,   block_type const* _right
+                ,   size_type _rightSize
+            );
+
+            // blocks finish() may write
+            size_type resultSize() const noexcept;
+
+            // writes the total and returns its normalized size
+            size_type finish( block_type * _result ) const;
+
+        private:
+
+            void grow( size_type _size );
+
+            /*-----------------------------------------------------------------------*/
+
+            std::pmr::vector< block_type > m_sums;
+
+            // m_carries[i] carries went into position i
+            std::pmr::vector< block_type > m_carries;
+
+            std::pmr::vector< block_type > m_product;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Summation
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIG_INTEGER_SUMMATION_HPP_
+
+/*-----------------------------------------------------------------------------------*/
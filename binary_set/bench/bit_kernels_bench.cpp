@@ -0,0 +1,118 @@
+/** (C) 2016 Ivan Semenenko */
+
+/*
+*  Throughput of the bit kernels available on this CPU, relative to the
+*  portable loops. Build together with the library sources, e.g.
+*
+*      g++ -std=c++17 -O2 -I../src bit_kernels_bench.cpp ../src/bit_kernels.cpp
+*/
+
+#include "bit_kernels.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using BitKernels::block_type;
+    using BitKernels::size_type;
+    using Clock = std::chrono::steady_clock;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // nanoseconds per block of the fastest of several runs
+    template< typename _Kernel >
+    double
+    measure( _Kernel _kernel, size_type _size )
+    {
+        size_type const repetitions = ( size_type( 1 ) << 26 ) / _size + 1;
+        double best = 0;
+
+        for( int run = 0; run < 5; ++run )
+        {
+            Clock::time_point start = Clock::now();
+
+            for( size_type count = 0; count < repetitions; ++count )
+                _kernel();
+
+            double elapsed = std::chrono::duration< double, std::nano >( Clock::now() - start ).count();
+            double perBlock = elapsed / ( repetitions * _size );
+
+            if( !run || perBlock < best )
+                best = perBlock;
+        }
+
+        return best;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+int
+main()
+{
+    std::mt19937_64 generator( 1 );
+    std::vector< BitKernels::Implementation > const& implementations = BitKernels::available();
+
+    std::printf( "selected: %s\n\n", BitKernels::selected().m_name );
+    std::printf( "%-10s %9s %9s %9s %9s %9s\n", "kernel", "blocks", "unite", "flip", "copy", "nonzero" );
+
+    // from the first cache level to well past the last one
+    for( size_type size : { 512, 32768, 4194304 } )
+    {
+        std::vector< block_type > left( size );
+        std::vector< block_type > right( size );
+        std::vector< block_type > result( size );
+        std::vector< block_type > const zero( size );
+
+        for( size_type count = 0; count < size; ++count )
+        {
+            left[count] = generator();
+            right[count] = generator();
+        }
+
+        double baseline[4] = {};
+
+        for( BitKernels::Implementation const& implementation : implementations )
+        {
+            volatile bool sink = false;
+
+            double timings[4] = {
+                    measure( [&]{ implementation.m_unite( result.data(), left.data(), right.data(), size ); }, size )
+                ,   measure( [&]{ implementation.m_flip( result.data(), left.data(), size ); }, size )
+                ,   measure( [&]{ implementation.m_copy( result.data(), left.data(), size ); }, size )
+                ,   measure( [&]{ sink = implementation.m_findNonZero( zero.data(), size ) == size; }, size )
+            };
+
+            if( &implementation == &implementations.front() )
+                std::copy( timings, timings + 4, baseline );
+
+            std::printf(
+                    "%-10s %9zu %6.3f ns %6.3f ns %6.3f ns %6.3f ns   speedup %.2fx %.2fx %.2fx %.2fx\n"
+                ,   implementation.m_name
+                ,   size
+                ,   timings[0]
+                ,   timings[1]
+                ,   timings[2]
+                ,   timings[3]
+                ,   baseline[0] / timings[0]
+                ,   baseline[1] / timings[1]
+                ,   baseline[2] / timings[2]
+                ,   baseline[3] / timings[3]
+            );
+        }
+    }
+
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -67,6 +67,46 @@ BinarySet::operator = ( BinarySet && _other )
 
 /*-----------------------------------------------------------------------------------*/
 
+BinarySet&
+BinarySet::operator |= ( BinarySet const& _other ) noexcept
+{
+    BinarySetUnite( *this, *this, _other );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet&
+BinarySet::operator &= ( BinarySet const& _other ) noexcept
+{
+    BinarySetIntersect( *this, *this, _other );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet&
+BinarySet::operator -= ( BinarySet const& _other ) noexcept
+{
+    BinarySetDifference( *this, *this, _other );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet&
+BinarySet::operator ^= ( BinarySet const& _other ) noexcept
+{
+    BinarySetSymmDiff( *this, *this, _other );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
 BinarySet::size_type
 BinarySet::size() const noexcept
 {
@@ -79,11 +119,16 @@ bool
 BinarySet::is_empty() const noexcept
 {
     size_type cellsCount = get_cell( m_size );
-    for( auto i = 0; i < cellsCount; ++i )
-        if( static_cast< bool >( m_pBitVector[i] ) )
-            return false;
 
-    return true;
+    return BitKernels::selected().m_findNonZero( m_pBitVector, cellsCount ) == cellsCount;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::count() const noexcept
+{
+    return BitKernels::selected().m_count( m_pBitVector, get_cell( m_size ) );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -106,7 +151,7 @@ bool
 BinarySet::has_key( size_type _index ) const
 {
     checkKeyRange( _index );
-    return m_pBitVector[get_pos( _index )] & ( 1 << _index );
+    return m_pBitVector[get_pos( _index )] & get_mask( _index );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -115,7 +160,7 @@ void
 BinarySet::insert_key( size_type _index )
 {
     checkKeyRange( _index );
-    m_pBitVector[get_pos( _index )] |= ( 1 << _index );
+    m_pBitVector[get_pos( _index )] |= get_mask( _index );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -124,7 +169,7 @@ void
 BinarySet::remove_key( size_type _index )
 {
     checkKeyRange( _index );
-    m_pBitVector[get_pos( _index )] &= ~( 1 << _index );
+    m_pBitVector[get_pos( _index )] &= ~get_mask( _index );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -133,7 +178,7 @@ void
 BinarySet::flip_key( size_type _index )
 {
     checkKeyRange( _index );
-    m_pBitVector[get_pos( _index )] ^= ( 1 << _index );
+    m_pBitVector[get_pos( _index )] ^= get_mask( _index );
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -145,9 +190,11 @@ BinarySet::set_bits() noexcept
 
     std::memset(
             m_pBitVector
-        ,    1
+        ,    0xFF
         ,    memorySize
     );
+
+    clear_tail();
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -163,35 +210,107 @@ BinarySet::reset_bits() noexcept
 void
 BinarySet::flip_bits() noexcept
 {
-    // TODO: consider better solution
-    size_type cellsCount = get_cell( m_size );
-    for( auto i = 0; i < cellsCount; ++i )
-        m_pBitVector[i] = ~m_pBitVector[i];
+    BitKernels::selected().m_flip( m_pBitVector, m_pBitVector, get_cell( m_size ) );
+
+    clear_tail();
 }
 
 /*-----------------------------------------------------------------------------------*/
 
-BinarySet
-BinarySetUnite( BinarySet const& _left,    BinarySet const& _right )
+BinarySet::const_iterator
+BinarySet::begin() const noexcept
+{
+    return const_iterator( *this, 0 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::const_iterator
+BinarySet::end() const noexcept
+{
+    return const_iterator( *this, get_cell( m_size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::find_first() const noexcept
+{
+    return find_next( 0 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::find_last() const noexcept
+{
+    return find_prev( m_size + 1 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::find_next( size_type _index ) const
+{
+    if( _index > m_size )
+        throw std::logic_error( Messages::OutOfRange );
+
+    // key _index + 1 is bit _index
+    if( _index == m_size )
+        return 0;
+
+    size_type cell = _index / BlockBits;
+    block_type block = m_pBitVector[cell] & ( ~block_type( 0 ) << ( _index % BlockBits ) );
+
+    if( !block )
+    {
+        cell = next_cell( cell + 1 );
+
+        if( cell == get_cell( m_size ) )
+            return 0;
+
+        block = m_pBitVector[cell];
+    }
+
+    return cell * BlockBits + BitKernels::countTrailingZeros( block ) + 1;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::find_prev( size_type _index ) const
 {
-    auto unite = [&](
-            BinarySet const& _bigger
-        ,    BinarySet const& _smaller
-    ) -> BinarySet
+    if( _index < 1 || _index > m_size + 1 )
+        throw std::logic_error( Messages::OutOfRange );
+
+    // keys below _index are the bits below _index - 1
+    if( _index == 1 )
+        return 0;
+
+    size_type last = _index - 2;
+    size_type cell = last / BlockBits;
+    block_type block = m_pBitVector[cell] & ( ~block_type( 0 ) >> ( BlockBits - 1 - last % BlockBits ) );
+
+    while( !block )
     {
-        BinarySet result( _bigger );
-        BinarySet::size_type smCells = _smaller.get_cell( _smaller.size() );
+        if( !cell )
+            return 0;
+
+        block = m_pBitVector[--cell];
+    }
+
+    return cell * BlockBits + BitKernels::highestBit( block ) + 1;
+}
 
-        for( auto i = 0; i < smCells; ++i )
-            result.m_pBitVector[i] |= _smaller.m_pBitVector[i];
+/*-----------------------------------------------------------------------------------*/
 
-        return result;
-    };
+BinarySet
+BinarySetUnite( BinarySet const& _left,    BinarySet const& _right )
+{
+    BinarySet result( std::max( _left.m_size, _right.m_size ) );
+    BinarySetUnite( result, _left, _right );
 
-    if( _left.m_size > _right.m_size )
-        return unite( _left, _right );
-    else
-        return unite( _right, _left );
+    return result;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -199,14 +318,8 @@ BinarySetUnite( BinarySet const& _left,    BinarySet const& _right )
 BinarySet
 BinarySetIntersect( BinarySet const& _left,    BinarySet const& _right )
 {
-    BinarySet::size_type minSize = std::min( _left.m_size, _right.m_size );
-    BinarySet result( minSize );
-
-    for( auto i = 0; i < result.get_cell( minSize ); ++i )
-        result.m_pBitVector[i] = 
-                _left.m_pBitVector[i]
-            &    _right.m_pBitVector[i]
-        ;
+    BinarySet result( std::min( _left.m_size, _right.m_size ) );
+    BinarySetIntersect( result, _left, _right );
 
     return result;
 }
@@ -216,14 +329,8 @@ BinarySetIntersect( BinarySet const& _left,    BinarySet const& _right )
 BinarySet
 BinarySetDifference( BinarySet const& _left,    BinarySet const& _right )
 {
-    BinarySet::size_type rSize = _left.m_size;
-    BinarySet result( rSize );
-
-    for( auto i = 0; i < result.get_cell( rSize ); ++i )
-        result.m_pBitVector[i] =
-                _left.m_pBitVector[i]
-            &    ~_right.m_pBitVector[i]
-        ;
+    BinarySet result( _left.m_size );
+    BinarySetDifference( result, _left, _right );
 
     return result;
 }
@@ -233,24 +340,85 @@ BinarySetDifference( BinarySet const& _left,    BinarySet const& _right )
 BinarySet
 BinarySetSymmDiff( BinarySet const& _left,    BinarySet const& _right )
 {
-    auto symDiff = [&](
-            BinarySet const& _bigger
-        ,    BinarySet const& _smaller
-    ) -> BinarySet
-    {
-        BinarySet result( _bigger );
-        BinarySet::block_type minCells = _smaller.get_cell( _smaller.m_size );
+    BinarySet result( std::max( _left.m_size, _right.m_size ) );
+    BinarySetSymmDiff( result, _left, _right );
 
-        for( auto i = 0; i < minCells; ++i )
-            result.m_pBitVector[i] ^= _right.m_pBitVector[i];
+    return result;
+}
 
-        return result;
-    };
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySetUnite( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept
+{
+    BinarySet::assign( _result, _left, _right, BitKernels::selected().m_unite, true, true );
+}
 
-    if( _left.m_size > _right.m_size )
-        return symDiff( _left, _right );
-    else
-        return symDiff( _right, _left );
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySetIntersect( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept
+{
+    BinarySet::assign( _result, _left, _right, BitKernels::selected().m_intersect, false, false );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySetDifference( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept
+{
+    BinarySet::assign( _result, _left, _right, BitKernels::selected().m_difference, true, false );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySetSymmDiff( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept
+{
+    BinarySet::assign( _result, _left, _right, BitKernels::selected().m_symmDiff, true, true );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySet::assign(
+        BinarySet & _result
+    ,   BinarySet const& _left
+    ,   BinarySet const& _right
+    ,   BinaryKernel _kernel
+    ,   bool _keepsLeft
+    ,   bool _keepsRight
+) noexcept
+{
+    size_type resultCells = _result.get_cell( _result.m_size );
+    size_type leftCells = _left.get_cell( _left.m_size );
+    size_type rightCells = _right.get_cell( _right.m_size );
+
+    size_type common = std::min( { resultCells, leftCells, rightCells } );
+
+    _kernel( _result.m_pBitVector, _left.m_pBitVector, _right.m_pBitVector, common );
+
+    // past the shorter operand the longer one alone decides
+    bool leftLonger = leftCells > rightCells;
+    BinarySet const& longer = leftLonger ? _left : _right;
+
+    size_type filled = ( leftLonger ? _keepsLeft : _keepsRight )
+        ?   std::min( resultCells, longer.get_cell( longer.m_size ) )
+        :   common
+    ;
+
+    // the result is already the longer operand when they are the same set
+    if( filled > common && &longer != &_result )
+        BitKernels::selected().m_copy(
+                _result.m_pBitVector + common
+            ,   longer.m_pBitVector + common
+            ,   filled - common
+        );
+
+    std::fill( _result.m_pBitVector + filled, _result.m_pBitVector + resultCells, 0 );
+
+    // a longer operand may have keys in the last block past the result size
+    _result.clear_tail();
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -258,7 +426,7 @@ BinarySetSymmDiff( BinarySet const& _left,    BinarySet const& _right )
 BinarySet::size_type
 BinarySet::get_cell( size_type _size ) const noexcept
 {
-    return ( _size - 1 ) / ( sizeof( block_type ) * 8) + 1;
+    return ( _size - 1 ) / BlockBits + 1;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -266,10 +434,43 @@ BinarySet::get_cell( size_type _size ) const noexcept
 BinarySet::size_type
 BinarySet::get_pos( size_type _index ) const noexcept
 {
-    size_type position = --_index;
-    position /= ( sizeof( block_type ) * 8 );
-    _index %= ( sizeof( block_type ) * 8 );
-    return position;
+    return ( _index - 1 ) / BlockBits;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::block_type
+BinarySet::get_mask( size_type _index ) const noexcept
+{
+    return block_type( 1 ) << ( ( _index - 1 ) % BlockBits );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet::size_type
+BinarySet::next_cell( size_type _cell ) const noexcept
+{
+    size_type cellsCount = get_cell( m_size );
+
+    // neighbouring keys mostly share a block or sit in the next one, the
+    // kernel pays off across longer runs of zero blocks
+    if( _cell >= cellsCount || m_pBitVector[_cell] )
+        return _cell;
+
+    ++_cell;
+
+    return _cell + BitKernels::selected().m_findNonZero( m_pBitVector + _cell, cellsCount - _cell );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+BinarySet::clear_tail() noexcept
+{
+    size_type used = m_size % BlockBits;
+
+    if( used )
+        m_pBitVector[get_cell( m_size ) - 1] &= ( block_type( 1 ) << used ) - 1;
 }
 
 /*-----------------------------------------------------------------------------------*/
@@ -281,10 +482,10 @@ BinarySet::copy_class( BinarySet const& _other )
     size_type cellsCount = get_cell( m_size );
     m_pBitVector = new block_type[cellsCount];
 
-    std::memcpy(
-        m_pBitVector
-        , _other.m_pBitVector
-        , cellsCount * sizeof( block_type )
+    BitKernels::selected().m_copy(
+            m_pBitVector
+        ,    _other.m_pBitVector
+        ,    cellsCount
     );
 }
 
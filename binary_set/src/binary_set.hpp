@@ -5,6 +5,10 @@
 
 /*-----------------------------------------------------------------------------------*/
 
+#include "bit_kernels.hpp"
+
+#include <cstddef>
+#include <iterator>
 #include <string>
 
 /*-----------------------------------------------------------------------------------*/
@@ -16,7 +20,7 @@ class BinarySet
 
         /*---------------------------------------------------------------------------*/
 
-        using block_type = unsigned int;
+        using block_type = BitKernels::block_type;
         using size_type = std::size_t;
         using bit_type = bool;
 
@@ -38,10 +42,26 @@ class BinarySet
 
         /*---------------------------------------------------------------------------*/
 
+        // in place, the set keeps its size and its blocks: keys of _other
+        // past size() are left out
+
+        BinarySet& operator |= ( BinarySet const& _other ) noexcept;
+
+        BinarySet& operator &= ( BinarySet const& _other ) noexcept;
+
+        BinarySet& operator -= ( BinarySet const& _other ) noexcept;
+
+        BinarySet& operator ^= ( BinarySet const& _other ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
         size_type size() const noexcept;
 
         bool is_empty() const noexcept;
 
+        // number of keys in the set
+        size_type count() const noexcept;
+
         void clear() noexcept;
 
         /*---------------------------------------------------------------------------*/
@@ -64,6 +84,33 @@ class BinarySet
 
         /*---------------------------------------------------------------------------*/
 
+        // the keys in increasing order; zero blocks are skipped whole
+        class const_iterator;
+
+        const_iterator begin() const noexcept;
+
+        const_iterator end() const noexcept;
+
+        // _callback( key ) for every key in increasing order
+        template< typename _Callback >
+        void for_each_key( _Callback _callback ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        // keys count from 1, so that 0 stands for no key at all
+
+        size_type find_first() const noexcept;
+
+        size_type find_last() const noexcept;
+
+        // the smallest key above _index, _index from 0 to size()
+        size_type find_next( size_type _index ) const;
+
+        // the largest key below _index, _index from 1 to size() + 1
+        size_type find_prev( size_type _index ) const;
+
+        /*---------------------------------------------------------------------------*/
+
         /*
         bit_type operator [] ( size_type _index ) const;
 
@@ -90,12 +137,62 @@ class BinarySet
 
         friend BinarySet BinarySetSymmDiff( BinarySet const& _left, BinarySet const& _right );
 
+        // into a preallocated _result, which keeps its size as the in-place
+        // operators do; _result may be either operand
+
+        friend void BinarySetUnite( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept;
+
+        friend void BinarySetIntersect( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept;
+
+        friend void BinarySetDifference( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept;
+
+        friend void BinarySetSymmDiff( BinarySet & _result, BinarySet const& _left, BinarySet const& _right ) noexcept;
+
+        friend class RankSelectIndex;
+
+        friend class RoaringSet;
+
     private:
 
+        static constexpr size_type BlockBits = sizeof( block_type ) * 8;
+
+        using BinaryKernel = void ( * )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        /*---------------------------------------------------------------------------*/
+
+        // _kernel over the blocks all three sets share; past the shorter
+        // operand the longer one is copied when its keys are kept, and
+        // zeroes fill the rest of _result
+        static void assign(
+                BinarySet & _result
+            ,   BinarySet const& _left
+            ,   BinarySet const& _right
+            ,   BinaryKernel _kernel
+            ,   bool _keepsLeft
+            ,   bool _keepsRight
+        ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
         size_type get_cell( size_type _size ) const noexcept;
 
         size_type get_pos( size_type _index ) const noexcept;
 
+        block_type get_mask( size_type _index ) const noexcept;
+
+        // the first block from _cell on that is not 0, the cells count
+        // when there is none
+        size_type next_cell( size_type _cell ) const noexcept;
+
+        // zeroes the bits past m_size in the last block, which every
+        // operation relies on
+        void clear_tail() noexcept;
+
         void copy_class( BinarySet const& _other );
 
         /*---------------------------------------------------------------------------*/
@@ -114,6 +211,145 @@ class BinarySet
 
 /*-----------------------------------------------------------------------------------*/
 
+class BinarySet::const_iterator
+{
+
+    public:
+
+        /*---------------------------------------------------------------------------*/
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = size_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = size_type;
+
+        /*---------------------------------------------------------------------------*/
+
+        const_iterator() noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        size_type operator * () const noexcept;
+
+        const_iterator& operator ++ () noexcept;
+
+        const_iterator operator ++ ( int ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        bool operator == ( const_iterator const& _other ) const noexcept;
+
+        bool operator != ( const_iterator const& _other ) const noexcept;
+
+    private:
+
+        friend class BinarySet;
+
+        /*---------------------------------------------------------------------------*/
+
+        // at the first key in _cell or after it
+        const_iterator( BinarySet const& _set, size_type _cell ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        BinarySet const* m_pSet;
+
+        size_type m_cell;
+
+        // the keys of m_cell not visited yet
+        block_type m_block;
+
+}; // class BinarySet::const_iterator
+
+/*-----------------------------------------------------------------------------------*/
+
+inline
+BinarySet::const_iterator::const_iterator() noexcept
+    :    m_pSet{ nullptr }
+    ,    m_cell{ 0 }
+    ,    m_block{ 0 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline
+BinarySet::const_iterator::const_iterator( BinarySet const& _set, size_type _cell ) noexcept
+    :    m_pSet{ &_set }
+    ,    m_cell{ _set.next_cell( _cell ) }
+    ,    m_block{ m_cell < _set.get_cell( _set.m_size ) ? _set.m_pBitVector[m_cell] : 0 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline BinarySet::size_type
+BinarySet::const_iterator::operator * () const noexcept
+{
+    return m_cell * BlockBits + BitKernels::countTrailingZeros( m_block ) + 1;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline BinarySet::const_iterator&
+BinarySet::const_iterator::operator ++ () noexcept
+{
+    // drops the lowest key, BLSR where available
+    m_block &= m_block - 1;
+
+    if( !m_block )
+        *this = const_iterator( *m_pSet, m_cell + 1 );
+
+    return *this;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline BinarySet::const_iterator
+BinarySet::const_iterator::operator ++ ( int ) noexcept
+{
+    const_iterator result( *this );
+    ++*this;
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline bool
+BinarySet::const_iterator::operator == ( const_iterator const& _other ) const noexcept
+{
+    return m_cell == _other.m_cell && m_block == _other.m_block;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+inline bool
+BinarySet::const_iterator::operator != ( const_iterator const& _other ) const noexcept
+{
+    return !( *this == _other );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Callback >
+void
+BinarySet::for_each_key( _Callback _callback ) const
+{
+    size_type cellsCount = get_cell( m_size );
+
+    for( size_type cell = next_cell( 0 ); cell < cellsCount; cell = next_cell( cell + 1 ) )
+    {
+        size_type base = cell * BlockBits + 1;
+
+        for( block_type block = m_pBitVector[cell]; block; block &= block - 1 )
+            _callback( base + BitKernels::countTrailingZeros( block ) );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
 #endif // BINARY_SET_HPP_
 
 /*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,608 @@
+/** (C) 2016 Ivan Semenenko */
+
+#include "bit_kernels.hpp"
+
+#include <cstring>
+
+#if defined( BINARY_SET_X86_64_KERNELS )
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+// MSVC compiles any intrinsic as is, GCC and Clang need the instruction
+// set enabled on the function using it
+#if defined( _MSC_VER )
+#define BINARY_SET_TARGET( _features )
+#else
+#define BINARY_SET_TARGET( _features ) __attribute__(( target( _features ) ))
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace BitKernels {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    enum class Operation
+    {
+            Unite
+        ,   Intersect
+        ,   Difference
+        ,   SymmDiff
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    inline block_type
+    apply( block_type _left, block_type _right ) noexcept
+    {
+        if constexpr( _operation == Operation::Unite )
+            return _left | _right;
+        else if constexpr( _operation == Operation::Intersect )
+            return _left & _right;
+        else if constexpr( _operation == Operation::Difference )
+            return _left & ~_right;
+        else
+            return _left ^ _right;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    void
+    combinePortable(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        for( size_type count = 0; count < _size; ++count )
+            _result[count] = apply< _operation >( _left[count], _right[count] );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    flipPortable( block_type * _result, block_type const* _source, size_type _size )
+    {
+        for( size_type count = 0; count < _size; ++count )
+            _result[count] = ~_source[count];
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the C library's memcpy already picks its widest loop at run time,
+    // vector loops of our own only come out slower
+    void
+    copyPortable( block_type * _result, block_type const* _source, size_type _size )
+    {
+        if( _size )
+            std::memcpy( _result, _source, _size * sizeof( block_type ) );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    size_type
+    findNonZeroPortable( block_type const* _data, size_type _size )
+    {
+        size_type count = 0;
+
+        while( count < _size && !_data[count] )
+            ++count;
+
+        return count;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    size_type
+    countPortable( block_type const* _data, size_type _size )
+    {
+        size_type result = 0;
+
+        for( size_type count = 0; count < _size; ++count )
+            result += popCount( _data[count] );
+
+        return result;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#if defined( BINARY_SET_X86_64_KERNELS )
+
+/*-----------------------------------------------------------------------------------*/
+
+    // POPCNT came with SSE4.2 rather than SSE2, the AVX2 and AVX-512
+    // variants count with it; four sums keep its latency hidden
+    BINARY_SET_TARGET( "popcnt" ) size_type
+    countPopcnt( block_type const* _data, size_type _size )
+    {
+        size_type sums[4] = {};
+        size_type count = 0;
+
+        for( ; count + 4 <= _size; count += 4 )
+        {
+            sums[0] += static_cast< size_type >( _mm_popcnt_u64( _data[count] ) );
+            sums[1] += static_cast< size_type >( _mm_popcnt_u64( _data[count + 1] ) );
+            sums[2] += static_cast< size_type >( _mm_popcnt_u64( _data[count + 2] ) );
+            sums[3] += static_cast< size_type >( _mm_popcnt_u64( _data[count + 3] ) );
+        }
+
+        for( ; count < _size; ++count )
+            sums[0] += static_cast< size_type >( _mm_popcnt_u64( _data[count] ) );
+
+        return sums[0] + sums[1] + sums[2] + sums[3];
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // SSE2 is part of x86-64, two blocks per vector
+
+    template< Operation _operation >
+    inline __m128i
+    apply128( __m128i _left, __m128i _right ) noexcept
+    {
+        if constexpr( _operation == Operation::Unite )
+            return _mm_or_si128( _left, _right );
+        else if constexpr( _operation == Operation::Intersect )
+            return _mm_and_si128( _left, _right );
+        else if constexpr( _operation == Operation::Difference )
+            return _mm_andnot_si128( _right, _left );
+        else
+            return _mm_xor_si128( _left, _right );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    void
+    combineSse2(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        size_type count = 0;
+
+        for( ; count + 2 <= _size; count += 2 )
+        {
+            __m128i left = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _left + count ) );
+            __m128i right = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _right + count ) );
+
+            _mm_storeu_si128(
+                    reinterpret_cast< __m128i* >( _result + count )
+                ,   apply128< _operation >( left, right )
+            );
+        }
+
+        combinePortable< _operation >( _result + count, _left + count, _right + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    void
+    flipSse2( block_type * _result, block_type const* _source, size_type _size )
+    {
+        __m128i const ones = _mm_set1_epi32( -1 );
+        size_type count = 0;
+
+        for( ; count + 2 <= _size; count += 2 )
+        {
+            __m128i source = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _source + count ) );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( _result + count ), _mm_xor_si128( source, ones ) );
+        }
+
+        flipPortable( _result + count, _source + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // four vectors are or-ed together between the tests
+    size_type
+    findNonZeroSse2( block_type const* _data, size_type _size )
+    {
+        __m128i const zero = _mm_setzero_si128();
+        size_type count = 0;
+
+        for( ; count + 8 <= _size; count += 8 )
+        {
+            __m128i const* data = reinterpret_cast< __m128i const* >( _data + count );
+
+            __m128i any = _mm_or_si128(
+                    _mm_or_si128( _mm_loadu_si128( data ), _mm_loadu_si128( data + 1 ) )
+                ,   _mm_or_si128( _mm_loadu_si128( data + 2 ), _mm_loadu_si128( data + 3 ) )
+            );
+
+            if( _mm_movemask_epi8( _mm_cmpeq_epi8( any, zero ) ) != 0xFFFF )
+                break;
+        }
+
+        return count + findNonZeroPortable( _data + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // AVX2, four blocks per vector
+
+    template< Operation _operation >
+    BINARY_SET_TARGET( "avx2" ) inline __m256i
+    apply256( __m256i _left, __m256i _right ) noexcept
+    {
+        if constexpr( _operation == Operation::Unite )
+            return _mm256_or_si256( _left, _right );
+        else if constexpr( _operation == Operation::Intersect )
+            return _mm256_and_si256( _left, _right );
+        else if constexpr( _operation == Operation::Difference )
+            return _mm256_andnot_si256( _right, _left );
+        else
+            return _mm256_xor_si256( _left, _right );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    BINARY_SET_TARGET( "avx2" ) void
+    combineAvx2(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        size_type count = 0;
+
+        for( ; count + 4 <= _size; count += 4 )
+        {
+            __m256i left = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _left + count ) );
+            __m256i right = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _right + count ) );
+
+            _mm256_storeu_si256(
+                    reinterpret_cast< __m256i* >( _result + count )
+                ,   apply256< _operation >( left, right )
+            );
+        }
+
+        combinePortable< _operation >( _result + count, _left + count, _right + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    BINARY_SET_TARGET( "avx2" ) void
+    flipAvx2( block_type * _result, block_type const* _source, size_type _size )
+    {
+        __m256i const ones = _mm256_set1_epi32( -1 );
+        size_type count = 0;
+
+        for( ; count + 4 <= _size; count += 4 )
+        {
+            __m256i source = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _source + count ) );
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( _result + count ), _mm256_xor_si256( source, ones ) );
+        }
+
+        flipPortable( _result + count, _source + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    BINARY_SET_TARGET( "avx2" ) size_type
+    findNonZeroAvx2( block_type const* _data, size_type _size )
+    {
+        size_type count = 0;
+
+        for( ; count + 16 <= _size; count += 16 )
+        {
+            __m256i const* data = reinterpret_cast< __m256i const* >( _data + count );
+
+            __m256i any = _mm256_or_si256(
+                    _mm256_or_si256( _mm256_loadu_si256( data ), _mm256_loadu_si256( data + 1 ) )
+                ,   _mm256_or_si256( _mm256_loadu_si256( data + 2 ), _mm256_loadu_si256( data + 3 ) )
+            );
+
+            if( !_mm256_testz_si256( any, any ) )
+                break;
+        }
+
+        return count + findNonZeroPortable( _data + count, _size - count );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // AVX-512, eight blocks per vector; the last partial vector is
+    // loaded and stored under a mask instead of block by block
+
+    inline __mmask8
+    tailMask( size_type _size ) noexcept
+    {
+        return static_cast< __mmask8 >( ( 1u << _size ) - 1 );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    BINARY_SET_TARGET( "avx512f" ) inline __m512i
+    apply512( __m512i _left, __m512i _right ) noexcept
+    {
+        if constexpr( _operation == Operation::Unite )
+            return _mm512_or_si512( _left, _right );
+        else if constexpr( _operation == Operation::Intersect )
+            return _mm512_and_si512( _left, _right );
+        // left & ~right as a truth table over ( left, right, right ): set
+        // where left is 1 and right 0; GCC's _mm512_andnot_si512 trips
+        // -Wmaybe-uninitialized inside its own header
+        else if constexpr( _operation == Operation::Difference )
+            return _mm512_ternarylogic_epi64( _left, _right, _right, 0x30 );
+        else
+            return _mm512_xor_si512( _left, _right );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< Operation _operation >
+    BINARY_SET_TARGET( "avx512f" ) void
+    combineAvx512(
+            block_type * _result
+        ,   block_type const* _left
+        ,   block_type const* _right
+        ,   size_type _size
+    )
+    {
+        size_type count = 0;
+
+        for( ; count + 8 <= _size; count += 8 )
+        {
+            __m512i left = _mm512_loadu_si512( _left + count );
+            __m512i right = _mm512_loadu_si512( _right + count );
+
+            _mm512_storeu_si512( _result + count, apply512< _operation >( left, right ) );
+        }
+
+        if( count == _size )
+            return;
+
+        __mmask8 mask = tailMask( _size - count );
+
+        __m512i left = _mm512_maskz_loadu_epi64( mask, _left + count );
+        __m512i right = _mm512_maskz_loadu_epi64( mask, _right + count );
+
+        _mm512_mask_storeu_epi64( _result + count, mask, apply512< _operation >( left, right ) );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    BINARY_SET_TARGET( "avx512f" ) void
+    flipAvx512( block_type * _result, block_type const* _source, size_type _size )
+    {
+        __m512i const ones = _mm512_set1_epi32( -1 );
+        size_type count = 0;
+
+        for( ; count + 8 <= _size; count += 8 )
+            _mm512_storeu_si512( _result + count, _mm512_xor_si512( _mm512_loadu_si512( _source + count ), ones ) );
+
+        if( count == _size )
+            return;
+
+        __mmask8 mask = tailMask( _size - count );
+
+        _mm512_mask_storeu_epi64(
+                _result + count
+            ,   mask
+            ,   _mm512_xor_si512( _mm512_maskz_loadu_epi64( mask, _source + count ), ones )
+        );
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the test mask of a vector gives the nonzero block directly
+    BINARY_SET_TARGET( "avx512f" ) size_type
+    findNonZeroAvx512( block_type const* _data, size_type _size )
+    {
+        size_type count = 0;
+
+        for( ; count + 32 <= _size; count += 32 )
+        {
+            block_type const* data = _data + count;
+
+            __m512i any = _mm512_or_si512(
+                    _mm512_or_si512( _mm512_loadu_si512( data ), _mm512_loadu_si512( data + 8 ) )
+                ,   _mm512_or_si512( _mm512_loadu_si512( data + 16 ), _mm512_loadu_si512( data + 24 ) )
+            );
+
+            if( _mm512_test_epi64_mask( any, any ) )
+                break;
+        }
+
+        for( ; count < _size; count += 8 )
+        {
+            __mmask8 mask = _size - count >= 8 ? __mmask8( 0xFF ) : tailMask( _size - count );
+            __m512i data = _mm512_maskz_loadu_epi64( mask, _data + count );
+
+            if( __mmask8 nonZero = _mm512_test_epi64_mask( data, data ) )
+                return count + countTrailingZeros( nonZero );
+        }
+
+        return _size;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    struct Features
+    {
+        bool m_avx2;
+
+        bool m_avx512;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the instruction sets the CPU has and the operating system saves the
+    // registers of
+    Features
+    detectFeatures()
+    {
+        unsigned leaf1[4];
+        unsigned leaf7[4] = {};
+
+#if defined( _MSC_VER )
+        int info[4];
+        __cpuid( info, 0 );
+        int const maxLeaf = info[0];
+
+        __cpuid( info, 1 );
+        for( int index = 0; index < 4; ++index )
+            leaf1[index] = static_cast< unsigned >( info[index] );
+
+        if( maxLeaf >= 7 )
+        {
+            __cpuidex( info, 7, 0 );
+            for( int index = 0; index < 4; ++index )
+                leaf7[index] = static_cast< unsigned >( info[index] );
+        }
+#else
+        if( !__get_cpuid( 1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3] ) )
+            return Features{ false, false };
+
+        __get_cpuid_count( 7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3] );
+#endif
+
+        // leaf 1, ECX: bit 23 is POPCNT, bit 27 OSXSAVE, without which
+        // XGETBV faults; every CPU with AVX2 has POPCNT too
+        if( !( leaf1[2] >> 27 & 1 ) || !( leaf1[2] >> 23 & 1 ) )
+            return Features{ false, false };
+
+#if defined( _MSC_VER )
+        unsigned long long const enabled = _xgetbv( 0 );
+#else
+        unsigned enabledLow;
+        unsigned enabledHigh;
+        __asm__( "xgetbv" : "=a" ( enabledLow ), "=d" ( enabledHigh ) : "c" ( 0 ) );
+        unsigned long long const enabled = ( static_cast< unsigned long long >( enabledHigh ) << 32 ) | enabledLow;
+#endif
+
+        // XCR0: bits 1 and 2 are the SSE and AVX state, 5 to 7 the
+        // AVX-512 mask and upper registers
+        bool const ymm = ( enabled & 0x06 ) == 0x06;
+        bool const zmm = ( enabled & 0xE6 ) == 0xE6;
+
+        // leaf 7, EBX: bit 5 is AVX2, bit 16 is AVX-512F
+        unsigned const features = leaf7[1];
+
+        return Features{ ymm && ( features >> 5 & 1 ), zmm && ( features >> 16 & 1 ) };
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BINARY_SET_X86_64_KERNELS
+
+/*-----------------------------------------------------------------------------------*/
+
+    Implementation const Portable{
+            "portable"
+        ,   combinePortable< Operation::Unite >
+        ,   combinePortable< Operation::Intersect >
+        ,   combinePortable< Operation::Difference >
+        ,   combinePortable< Operation::SymmDiff >
+        ,   flipPortable
+        ,   copyPortable
+        ,   findNonZeroPortable
+        ,   countPortable
+    };
+
+#if defined( BINARY_SET_X86_64_KERNELS )
+
+    Implementation const Sse2{
+            "sse2"
+        ,   combineSse2< Operation::Unite >
+        ,   combineSse2< Operation::Intersect >
+        ,   combineSse2< Operation::Difference >
+        ,   combineSse2< Operation::SymmDiff >
+        ,   flipSse2
+        ,   copyPortable
+        ,   findNonZeroSse2
+        ,   countPortable
+    };
+
+    Implementation const Avx2{
+            "avx2"
+        ,   combineAvx2< Operation::Unite >
+        ,   combineAvx2< Operation::Intersect >
+        ,   combineAvx2< Operation::Difference >
+        ,   combineAvx2< Operation::SymmDiff >
+        ,   flipAvx2
+        ,   copyPortable
+        ,   findNonZeroAvx2
+        ,   countPopcnt
+    };
+
+    Implementation const Avx512{
+            "avx512"
+        ,   combineAvx512< Operation::Unite >
+        ,   combineAvx512< Operation::Intersect >
+        ,   combineAvx512< Operation::Difference >
+        ,   combineAvx512< Operation::SymmDiff >
+        ,   flipAvx512
+        ,   copyPortable
+        ,   findNonZeroAvx512
+        ,   countPopcnt
+    };
+
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+std::vector< Implementation > const&
+available()
+{
+    static std::vector< Implementation > const implementations = []
+    {
+        std::vector< Implementation > result{ Portable };
+
+#if defined( BINARY_SET_X86_64_KERNELS )
+        result.push_back( Sse2 );
+
+        Features const features = detectFeatures();
+
+        if( features.m_avx2 )
+            result.push_back( Avx2 );
+
+        if( features.m_avx512 )
+            result.push_back( Avx512 );
+#endif
+
+        return result;
+    }();
+
+    return implementations;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Implementation const&
+selected()
+{
+    static Implementation const implementation = available().back();
+
+    return implementation;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace BitKernels
+
+/*-----------------------------------------------------------------------------------*/
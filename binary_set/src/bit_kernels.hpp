@@ -0,0 +1,186 @@
+/** (C) 2016 Ivan Semenenko */
+
+#ifndef BIT_KERNELS_HPP_
+#define BIT_KERNELS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Word-wise loops behind the BinarySet operations. On x86-64 they come
+*  in SSE2, AVX2 and AVX-512 variants; the widest one the CPU and the
+*  operating system support is picked once, on first use, from what CPUID
+*  and XGETBV report. Defining BINARY_SET_PORTABLE_KERNELS forces the
+*  plain C++ loops.
+*/
+
+#if !defined( BINARY_SET_PORTABLE_KERNELS ) && ( defined( __x86_64__ ) || defined( _M_X64 ) )
+#define BINARY_SET_X86_64_KERNELS
+#endif
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace BitKernels {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using block_type = std::uint64_t;
+    using size_type = std::size_t;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // loops over _size blocks; _result may be the same array as an operand
+    struct Implementation
+    {
+        char const* m_name;
+
+        // _result = _left | _right
+        void ( *m_unite )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result = _left & _right
+        void ( *m_intersect )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result = _left & ~_right
+        void ( *m_difference )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result = _left ^ _right
+        void ( *m_symmDiff )(
+                block_type * _result
+            ,   block_type const* _left
+            ,   block_type const* _right
+            ,   size_type _size
+        );
+
+        // _result = ~_source
+        void ( *m_flip )(
+                block_type * _result
+            ,   block_type const* _source
+            ,   size_type _size
+        );
+
+        // _result = _source, the arrays do not overlap
+        void ( *m_copy )(
+                block_type * _result
+            ,   block_type const* _source
+            ,   size_type _size
+        );
+
+        // index of the first block that is not 0, _size when all are
+        size_type ( *m_findNonZero )( block_type const* _data, size_type _size );
+
+        // number of bits set
+        size_type ( *m_count )( block_type const* _data, size_type _size );
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    // implementations the running CPU supports, the portable one first
+    std::vector< Implementation > const& available();
+
+    // the widest of them, used by BinarySet
+    Implementation const& selected();
+
+/*-----------------------------------------------------------------------------------*/
+
+    // bits set in a single block
+    inline size_type
+    popCount( block_type _block ) noexcept
+    {
+#if defined( __GNUC__ )
+        return static_cast< size_type >( __builtin_popcountll( _block ) );
+#else
+        _block -= ( _block >> 1 ) & 0x5555555555555555;
+        _block = ( _block & 0x3333333333333333 ) + ( ( _block >> 2 ) & 0x3333333333333333 );
+        _block = ( _block + ( _block >> 4 ) ) & 0x0F0F0F0F0F0F0F0F;
+
+        return static_cast< size_type >( ( _block * 0x0101010101010101 ) >> 56 );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // position of the lowest bit set, _block is not 0
+    inline unsigned
+    countTrailingZeros( block_type _block ) noexcept
+    {
+#if defined( _MSC_VER )
+        unsigned long index;
+        _BitScanForward64( &index, _block );
+        return static_cast< unsigned >( index );
+#else
+        return static_cast< unsigned >( __builtin_ctzll( _block ) );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // position of the highest bit set, _block is not 0
+    inline unsigned
+    highestBit( block_type _block ) noexcept
+    {
+#if defined( _MSC_VER )
+        unsigned long index;
+        _BitScanReverse64( &index, _block );
+        return static_cast< unsigned >( index );
+#else
+        return static_cast< unsigned >( 63 - __builtin_clzll( _block ) );
+#endif
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // position of the bit set with _rank bits set below it, _rank less
+    // than popCount( _block ); a byte at a time, then a bit at a time
+    inline unsigned
+    selectBit( block_type _block, size_type _rank ) noexcept
+    {
+        unsigned position = 0;
+
+        for( ;; position += 8 )
+        {
+            size_type inByte = popCount( ( _block >> position ) & 0xFF );
+
+            if( _rank < inByte )
+                break;
+
+            _rank -= inByte;
+        }
+
+        for( ;; ++position )
+            if( ( _block >> position & 1 ) && !_rank-- )
+                return position;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace BitKernels
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // BIT_KERNELS_HPP_
+
+/*-----------------------------------------------------------------------------------*/
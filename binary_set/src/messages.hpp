@@ -9,9 +9,11 @@ namespace Messages {
 
 /*---------------------------------------------------------------------------*/
 
-    constexpr const char* const OutOfRange    = "Key value is out of range";
+    constexpr const char* const OutOfRange     = "Key value is out of range";
 
-    constexpr const char* const InvalidSize   = "The size must be more than 0";
+    constexpr const char* const InvalidSize    = "The size must be more than 0";
+
+    constexpr const char* const RankOutOfRange = "Rank is out of range";
 
 /*---------------------------------------------------------------------------*/
 
@@ -0,0 +1,133 @@
+/** (C) 2016 Ivan Semenenko */
+
+#include "rank_select_index.hpp"
+#include "messages.hpp"
+
+#include <stdexcept>
+
+/*-----------------------------------------------------------------------------------*/
+
+RankSelectIndex::RankSelectIndex( BinarySet const& _set )
+    :    m_pBlocks{ _set.m_pBitVector }
+    ,    m_blocksCount{ _set.get_cell( _set.m_size ) }
+    ,    m_size{ _set.m_size }
+    ,    m_count{ 0 }
+{
+    size_type superblocks = ( m_blocksCount - 1 ) / SuperblockBlocks + 1;
+    m_counts.resize( 2 * superblocks );
+
+    for( size_type superblock = 0; superblock < superblocks; ++superblock )
+    {
+        block_type packed = 0;
+        size_type inside = 0;
+
+        for( size_type block = 0; block < SuperblockBlocks; ++block )
+        {
+            if( block )
+                packed |= block_type( inside ) << ( 9 * ( block - 1 ) );
+
+            size_type index = superblock * SuperblockBlocks + block;
+
+            if( index < m_blocksCount )
+                inside += BitKernels::popCount( m_pBlocks[index] );
+        }
+
+        m_counts[2 * superblock] = m_count;
+        m_counts[2 * superblock + 1] = packed;
+
+        m_count += inside;
+
+        // the next sampled key, counting from 1, lies in this superblock
+        while( m_samples.size() * SelectSample < m_count )
+            m_samples.push_back( superblock );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RankSelectIndex::size_type
+RankSelectIndex::count() const noexcept
+{
+    return m_count;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RankSelectIndex::size_type
+RankSelectIndex::rank( size_type _index ) const
+{
+    if( _index > m_size )
+        throw std::logic_error( Messages::OutOfRange );
+
+    if( _index == m_size )
+        return m_count;
+
+    // keys 1 to _index are the bits below position _index
+    size_type block = _index / ( sizeof( block_type ) * 8 );
+    unsigned bit = _index % ( sizeof( block_type ) * 8 );
+
+    size_type superblock = block / SuperblockBlocks;
+    size_type result = m_counts[2 * superblock] + keysBefore( superblock, block % SuperblockBlocks );
+
+    if( bit )
+        result += BitKernels::popCount( m_pBlocks[block] & ( ( block_type( 1 ) << bit ) - 1 ) );
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RankSelectIndex::size_type
+RankSelectIndex::select( size_type _rank ) const
+{
+    if( !_rank || _rank > m_count )
+        throw std::logic_error( Messages::RankOutOfRange );
+
+    // the last superblock with fewer than _rank keys before it lies
+    // between the superblocks of the samples around _rank
+    size_type sample = ( _rank - 1 ) / SelectSample;
+
+    size_type low = m_samples[sample];
+    size_type high = sample + 1 < m_samples.size()
+        ?   m_samples[sample + 1]
+        :   m_counts.size() / 2 - 1
+    ;
+
+    while( low < high )
+    {
+        size_type middle = low + ( high - low + 1 ) / 2;
+
+        if( m_counts[2 * middle] < _rank )
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    _rank -= m_counts[2 * low];
+
+    size_type block = 0;
+    while( block + 1 < SuperblockBlocks && keysBefore( low, block + 1 ) < _rank )
+        ++block;
+
+    _rank -= keysBefore( low, block );
+
+    size_type index = low * SuperblockBlocks + block;
+
+    return index * ( sizeof( block_type ) * 8 )
+        +   BitKernels::selectBit( m_pBlocks[index], _rank - 1 )
+        +   1
+    ;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RankSelectIndex::size_type
+RankSelectIndex::keysBefore( size_type _superblock, size_type _block ) const noexcept
+{
+    if( !_block )
+        return 0;
+
+    return ( m_counts[2 * _superblock + 1] >> ( 9 * ( _block - 1 ) ) ) & 0x1FF;
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,88 @@
+/** (C) 2016 Ivan Semenenko */
+
+#ifndef RANK_SELECT_INDEX_HPP_
+#define RANK_SELECT_INDEX_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "binary_set.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  Succinct rank/select directory over a BinarySet, about a quarter of the
+*  set's own memory on top of it. The blocks are grouped eight at a time
+*  into superblocks; for every superblock the directory keeps the number
+*  of keys before it and, packed 9 bits each into one more word, the
+*  number of keys before each of its blocks. A rank is then two lookups
+*  and one popcount. For select every 512th key remembers its superblock,
+*  the search goes on between two such samples and ends inside a block.
+*
+*  The index reads the set's blocks: the set must outlive it, and the
+*  index must be built again once the set changes.
+*/
+
+class RankSelectIndex
+{
+
+    public:
+
+        /*---------------------------------------------------------------------------*/
+
+        using size_type = BinarySet::size_type;
+
+        /*---------------------------------------------------------------------------*/
+
+        explicit RankSelectIndex( BinarySet const& _set );
+
+        /*---------------------------------------------------------------------------*/
+
+        // number of keys in the set
+        size_type count() const noexcept;
+
+        // number of keys not greater than _index, from 0 to the set size
+        size_type rank( size_type _index ) const;
+
+        // the key with _rank - 1 keys below it, _rank from 1 to count()
+        size_type select( size_type _rank ) const;
+
+    private:
+
+        using block_type = BinarySet::block_type;
+
+        /*---------------------------------------------------------------------------*/
+
+        static constexpr size_type SuperblockBlocks = 8;
+
+        static constexpr size_type SelectSample = 512;
+
+        /*---------------------------------------------------------------------------*/
+
+        // keys in the first _block blocks of _superblock, _block below 8
+        size_type keysBefore( size_type _superblock, size_type _block ) const noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        block_type const* m_pBlocks;
+
+        size_type m_blocksCount;
+
+        size_type m_size;
+
+        size_type m_count;
+
+        // for every superblock the keys before it, then the packed counts
+        std::vector< block_type > m_counts;
+
+        // superblock of every SelectSample-th key, starting with the first
+        std::vector< size_type > m_samples;
+
+}; // class RankSelectIndex
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // RANK_SELECT_INDEX_HPP_
+
+/*-----------------------------------------------------------------------------------*/
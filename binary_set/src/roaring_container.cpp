@@ -0,0 +1,668 @@
+/** (C) 2016 Ivan Semenenko */
+
+#include "roaring_container.hpp"
+
+#include <algorithm>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace Roaring {
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    constexpr size_type BlockBits = sizeof( block_type ) * 8;
+
+/*-----------------------------------------------------------------------------------*/
+
+    // whether a value in the left operand, the right one or both is in
+    // the result
+    bool
+    keeps( Operation _operation, bool _inLeft, bool _inRight ) noexcept
+    {
+        switch( _operation )
+        {
+            case Operation::Unite:
+                return _inLeft || _inRight;
+
+            case Operation::Intersect:
+                return _inLeft && _inRight;
+
+            case Operation::Difference:
+                return _inLeft && !_inRight;
+
+            default:
+                return _inLeft != _inRight;
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+    // sets the bits _first to _last
+    void
+    setRange( block_type * _blocks, size_type _first, size_type _last ) noexcept
+    {
+        size_type firstBlock = _first / BlockBits;
+        size_type lastBlock = _last / BlockBits;
+
+        block_type firstMask = ~block_type( 0 ) << ( _first % BlockBits );
+        block_type lastMask = ~block_type( 0 ) >> ( BlockBits - 1 - _last % BlockBits );
+
+        if( firstBlock == lastBlock )
+        {
+            _blocks[firstBlock] |= firstMask & lastMask;
+            return;
+        }
+
+        _blocks[firstBlock] |= firstMask;
+        std::fill( _blocks + firstBlock + 1, _blocks + lastBlock, ~block_type( 0 ) );
+        _blocks[lastBlock] |= lastMask;
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+Container::Container() noexcept
+    :    m_kind{ Kind::Array }
+    ,    m_cardinality{ 0 }
+{
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::from_blocks( block_type const* _blocks, size_type _count )
+{
+    BitKernels::Implementation const& kernels = BitKernels::selected();
+
+    Container result;
+
+    result.m_kind = Kind::Bitmap;
+    result.m_bitmap.assign( BitmapBlocks, 0 );
+
+    kernels.m_copy( result.m_bitmap.data(), _blocks, _count );
+    result.m_cardinality = kernels.m_count( _blocks, _count );
+
+    result.optimize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::combine( Operation _operation, Container const& _left, Container const& _right )
+{
+    Container result;
+
+    // arrays and runs are merged as they are, an array meeting anything
+    // else in an intersection or on the left of a difference can only
+    // lose values; the remaining cases work on bitmaps
+    if( _left.m_kind == Kind::Array && _right.m_kind == Kind::Array )
+        result = merge_arrays( _operation, _left, _right );
+
+    else if( _left.m_kind == Kind::Runs && _right.m_kind == Kind::Runs )
+        result = merge_runs( _operation, _left, _right );
+
+    else if( _operation == Operation::Intersect && _right.m_kind == Kind::Array )
+        result = filter( _operation, _right, _left );
+
+    else if(
+            ( _operation == Operation::Intersect || _operation == Operation::Difference )
+        &&  _left.m_kind == Kind::Array
+    )
+        result = filter( _operation, _left, _right );
+
+    else
+        result = combine_bitmaps( _operation, _left, _right );
+
+    result.optimize();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container::Kind
+Container::kind() const noexcept
+{
+    return m_kind;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Container::cardinality() const noexcept
+{
+    return m_cardinality;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Container::is_empty() const noexcept
+{
+    return !m_cardinality;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Container::memory() const noexcept
+{
+    switch( m_kind )
+    {
+        case Kind::Array:
+            return m_array.size() * sizeof( value_type );
+
+        case Kind::Bitmap:
+            return m_bitmap.size() * sizeof( block_type );
+
+        default:
+            return m_runs.size() * sizeof( Run );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+Container::contains( value_type _value ) const noexcept
+{
+    switch( m_kind )
+    {
+        case Kind::Array:
+            return std::binary_search( m_array.begin(), m_array.end(), _value );
+
+        case Kind::Bitmap:
+            return m_bitmap[_value / BlockBits] >> ( _value % BlockBits ) & 1;
+
+        default:
+        {
+            // the last run starting at _value or before
+            auto run = std::upper_bound(
+                    m_runs.begin()
+                ,   m_runs.end()
+                ,   _value
+                ,   []( value_type _value, Run const& _run ){ return _value < _run.m_first; }
+            );
+
+            return run != m_runs.begin() && _value <= ( run - 1 )->m_last;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::insert( value_type _value )
+{
+    switch( m_kind )
+    {
+        case Kind::Array:
+        {
+            auto position = std::lower_bound( m_array.begin(), m_array.end(), _value );
+
+            if( position != m_array.end() && *position == _value )
+                return;
+
+            m_array.insert( position, _value );
+
+            if( ++m_cardinality > ArrayLimit )
+                to_bitmap();
+
+            return;
+        }
+
+        case Kind::Bitmap:
+        {
+            block_type & block = m_bitmap[_value / BlockBits];
+            block_type mask = block_type( 1 ) << ( _value % BlockBits );
+
+            if( block & mask )
+                return;
+
+            block |= mask;
+            ++m_cardinality;
+
+            return;
+        }
+
+        case Kind::Runs:
+        {
+            // the first run ending at _value or after, and the one before
+            auto next = std::lower_bound(
+                    m_runs.begin()
+                ,   m_runs.end()
+                ,   _value
+                ,   []( Run const& _run, value_type _value ){ return _run.m_last < _value; }
+            );
+
+            if( next != m_runs.end() && next->m_first <= _value )
+                return;
+
+            bool joinsPrevious = next != m_runs.begin() && ( next - 1 )->m_last + 1 == _value;
+            bool joinsNext = next != m_runs.end() && next->m_first == _value + 1;
+
+            if( joinsPrevious && joinsNext )
+            {
+                ( next - 1 )->m_last = next->m_last;
+                m_runs.erase( next );
+            }
+            else if( joinsPrevious )
+                ( next - 1 )->m_last = _value;
+            else if( joinsNext )
+                next->m_first = _value;
+            else
+                m_runs.insert( next, Run{ _value, _value } );
+
+            ++m_cardinality;
+
+            return;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::remove( value_type _value )
+{
+    switch( m_kind )
+    {
+        case Kind::Array:
+        {
+            auto position = std::lower_bound( m_array.begin(), m_array.end(), _value );
+
+            if( position == m_array.end() || *position != _value )
+                return;
+
+            m_array.erase( position );
+            --m_cardinality;
+
+            return;
+        }
+
+        case Kind::Bitmap:
+        {
+            block_type & block = m_bitmap[_value / BlockBits];
+            block_type mask = block_type( 1 ) << ( _value % BlockBits );
+
+            if( !( block & mask ) )
+                return;
+
+            block &= ~mask;
+
+            if( --m_cardinality <= ArrayLimit )
+                to_array();
+
+            return;
+        }
+
+        case Kind::Runs:
+        {
+            auto run = std::lower_bound(
+                    m_runs.begin()
+                ,   m_runs.end()
+                ,   _value
+                ,   []( Run const& _run, value_type _value ){ return _run.m_last < _value; }
+            );
+
+            if( run == m_runs.end() || run->m_first > _value )
+                return;
+
+            if( run->m_first == run->m_last )
+                m_runs.erase( run );
+            else if( run->m_first == _value )
+                ++run->m_first;
+            else if( run->m_last == _value )
+                --run->m_last;
+            else
+            {
+                Run upper{ static_cast< value_type >( _value + 1 ), run->m_last };
+
+                run->m_last = static_cast< value_type >( _value - 1 );
+                m_runs.insert( run + 1, upper );
+            }
+
+            --m_cardinality;
+
+            return;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::to_blocks( block_type * _blocks ) const noexcept
+{
+    if( m_kind == Kind::Bitmap )
+    {
+        BitKernels::selected().m_copy( _blocks, m_bitmap.data(), BitmapBlocks );
+        return;
+    }
+
+    std::fill_n( _blocks, BitmapBlocks, 0 );
+
+    if( m_kind == Kind::Array )
+        for( value_type value : m_array )
+            _blocks[value / BlockBits] |= block_type( 1 ) << ( value % BlockBits );
+    else
+        for( Run const& run : m_runs )
+            setRange( _blocks, run.m_first, run.m_last );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::optimize()
+{
+    size_type runsMemory = count_runs() * sizeof( Run );
+
+    size_type otherMemory = m_cardinality <= ArrayLimit
+        ?   m_cardinality * sizeof( value_type )
+        :   BitmapBlocks * sizeof( block_type )
+    ;
+
+    if( runsMemory < otherMemory )
+        to_runs();
+    else if( m_cardinality <= ArrayLimit )
+        to_array();
+    else
+        to_bitmap();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::merge_arrays( Operation _operation, Container const& _left, Container const& _right )
+{
+    std::vector< value_type > const& left = _left.m_array;
+    std::vector< value_type > const& right = _right.m_array;
+
+    Container result;
+    size_type leftIndex = 0;
+    size_type rightIndex = 0;
+
+    while( leftIndex < left.size() || rightIndex < right.size() )
+    {
+        bool inLeft = rightIndex == right.size()
+            ||  ( leftIndex < left.size() && left[leftIndex] <= right[rightIndex] );
+
+        bool inRight = leftIndex == left.size()
+            ||  ( rightIndex < right.size() && right[rightIndex] <= left[leftIndex] );
+
+        value_type value = inLeft ? left[leftIndex++] : right[rightIndex];
+
+        if( inRight )
+            ++rightIndex;
+
+        if( keeps( _operation, inLeft, inRight ) )
+            result.m_array.push_back( value );
+    }
+
+    result.m_cardinality = result.m_array.size();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::merge_runs( Operation _operation, Container const& _left, Container const& _right )
+{
+    std::vector< Run > const& left = _left.m_runs;
+    std::vector< Run > const& right = _right.m_runs;
+
+    // past every boundary, which are at most ChunkValues
+    constexpr size_type End = ChunkValues + 1;
+
+    Container result;
+    result.m_kind = Kind::Runs;
+
+    size_type leftIndex = 0;
+    size_type rightIndex = 0;
+    bool inLeft = false;
+    bool inRight = false;
+    bool inResult = false;
+    size_type first = 0;
+
+    // walks the boundaries of both operands in order, opening and closing
+    // the result runs wherever membership changes
+    for( ;; )
+    {
+        size_type leftBoundary = leftIndex == left.size()
+            ?   End
+            :   inLeft ? left[leftIndex].m_last + size_type( 1 ) : left[leftIndex].m_first
+        ;
+
+        size_type rightBoundary = rightIndex == right.size()
+            ?   End
+            :   inRight ? right[rightIndex].m_last + size_type( 1 ) : right[rightIndex].m_first
+        ;
+
+        size_type position = std::min( leftBoundary, rightBoundary );
+
+        if( position == End )
+            break;
+
+        if( leftBoundary == position )
+        {
+            leftIndex += inLeft;
+            inLeft = !inLeft;
+        }
+
+        if( rightBoundary == position )
+        {
+            rightIndex += inRight;
+            inRight = !inRight;
+        }
+
+        bool in = keeps( _operation, inLeft, inRight );
+
+        if( in == inResult )
+            continue;
+
+        if( in )
+            first = position;
+        else
+        {
+            result.m_runs.push_back( Run{ static_cast< value_type >( first ), static_cast< value_type >( position - 1 ) } );
+            result.m_cardinality += position - first;
+        }
+
+        inResult = in;
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::filter( Operation _operation, Container const& _values, Container const& _other )
+{
+    bool const keepContained = _operation == Operation::Intersect;
+
+    Container result;
+
+    for( value_type value : _values.m_array )
+        if( _other.contains( value ) == keepContained )
+            result.m_array.push_back( value );
+
+    result.m_cardinality = result.m_array.size();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Container
+Container::combine_bitmaps( Operation _operation, Container const& _left, Container const& _right )
+{
+    BitKernels::Implementation const& kernels = BitKernels::selected();
+
+    std::vector< block_type > leftScratch;
+    std::vector< block_type > rightScratch;
+
+    auto bitmapOf = [&]( Container const& _container, std::vector< block_type > & _scratch )
+        -> block_type const*
+    {
+        if( _container.m_kind == Kind::Bitmap )
+            return _container.m_bitmap.data();
+
+        _scratch.resize( BitmapBlocks );
+        _container.to_blocks( _scratch.data() );
+
+        return _scratch.data();
+    };
+
+    block_type const* left = bitmapOf( _left, leftScratch );
+    block_type const* right = bitmapOf( _right, rightScratch );
+
+    Container result;
+
+    result.m_kind = Kind::Bitmap;
+    result.m_bitmap.resize( BitmapBlocks );
+
+    block_type* blocks = result.m_bitmap.data();
+
+    switch( _operation )
+    {
+        case Operation::Unite:
+            kernels.m_unite( blocks, left, right, BitmapBlocks );
+            break;
+
+        case Operation::Intersect:
+            kernels.m_intersect( blocks, left, right, BitmapBlocks );
+            break;
+
+        case Operation::Difference:
+            kernels.m_difference( blocks, left, right, BitmapBlocks );
+            break;
+
+        case Operation::SymmDiff:
+            kernels.m_symmDiff( blocks, left, right, BitmapBlocks );
+            break;
+    }
+
+    result.m_cardinality = kernels.m_count( blocks, BitmapBlocks );
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+size_type
+Container::count_runs() const noexcept
+{
+    switch( m_kind )
+    {
+        case Kind::Array:
+        {
+            size_type runs = 0;
+
+            for( size_type index = 0; index < m_array.size(); ++index )
+                if( !index || m_array[index] != m_array[index - 1] + 1 )
+                    ++runs;
+
+            return runs;
+        }
+
+        case Kind::Bitmap:
+        {
+            // a run starts at every bit set whose lower neighbour is clear
+            size_type runs = 0;
+            block_type carry = 0;
+
+            for( block_type block : m_bitmap )
+            {
+                runs += BitKernels::popCount( block & ~( ( block << 1 ) | carry ) );
+                carry = block >> ( BlockBits - 1 );
+            }
+
+            return runs;
+        }
+
+        default:
+            return m_runs.size();
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::to_array()
+{
+    if( m_kind == Kind::Array )
+        return;
+
+    std::vector< value_type > values;
+    values.reserve( m_cardinality );
+
+    for_each( [&]( value_type _value ){ values.push_back( _value ); } );
+
+    m_array.swap( values );
+    std::vector< block_type >().swap( m_bitmap );
+    std::vector< Run >().swap( m_runs );
+
+    m_kind = Kind::Array;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::to_bitmap()
+{
+    if( m_kind == Kind::Bitmap )
+        return;
+
+    std::vector< block_type > blocks( BitmapBlocks );
+    to_blocks( blocks.data() );
+
+    m_bitmap.swap( blocks );
+    std::vector< value_type >().swap( m_array );
+    std::vector< Run >().swap( m_runs );
+
+    m_kind = Kind::Bitmap;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+Container::to_runs()
+{
+    if( m_kind == Kind::Runs )
+        return;
+
+    std::vector< Run > runs;
+    runs.reserve( count_runs() );
+
+    for_each(
+        [&]( value_type _value )
+        {
+            if( !runs.empty() && runs.back().m_last + 1 == _value )
+                runs.back().m_last = _value;
+            else
+                runs.push_back( Run{ _value, _value } );
+        }
+    );
+
+    m_runs.swap( runs );
+    std::vector< value_type >().swap( m_array );
+    std::vector< block_type >().swap( m_bitmap );
+
+    m_kind = Kind::Runs;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Roaring
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,218 @@
+/** (C) 2016 Ivan Semenenko */
+
+#ifndef ROARING_CONTAINER_HPP_
+#define ROARING_CONTAINER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "bit_kernels.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  The values 0 to 65535 of one chunk of a RoaringSet, kept as whichever
+*  of three forms takes the least memory:
+*
+*      array   - the values sorted, 2 bytes each, for up to 4096 of them
+*      bitmap  - 1024 blocks, 8 KiB whatever the count
+*      runs    - first and last value of every run of consecutive ones,
+*                4 bytes per run
+*
+*  Single insertions and removals keep the form, but for an array grown
+*  past 4096 values or a bitmap shrunk to that many; optimize() chooses
+*  again. Combined containers come out optimized.
+*/
+
+namespace Roaring {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using block_type = BitKernels::block_type;
+    using size_type = BitKernels::size_type;
+    using value_type = std::uint16_t;
+
+/*-----------------------------------------------------------------------------------*/
+
+    constexpr size_type ChunkBits = 16;
+
+    constexpr size_type ChunkValues = size_type( 1 ) << ChunkBits;
+
+    constexpr size_type BitmapBlocks = ChunkValues / ( sizeof( block_type ) * 8 );
+
+    // an array of more values takes more room than the bitmap
+    constexpr size_type ArrayLimit = BitmapBlocks * sizeof( block_type ) / sizeof( value_type );
+
+/*-----------------------------------------------------------------------------------*/
+
+    enum class Operation
+    {
+            Unite
+        ,   Intersect
+        ,   Difference
+        ,   SymmDiff
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    struct Run
+    {
+        value_type m_first;
+
+        value_type m_last;
+    };
+
+/*-----------------------------------------------------------------------------------*/
+
+    class Container
+    {
+
+        public:
+
+            /*-----------------------------------------------------------------------*/
+
+            enum class Kind
+            {
+                    Array
+                ,   Bitmap
+                ,   Runs
+            };
+
+            /*-----------------------------------------------------------------------*/
+
+            // an empty array
+            Container() noexcept;
+
+            // the bits set in _count blocks of a dense bitmap, at most
+            // BitmapBlocks of them
+            static Container from_blocks( block_type const* _blocks, size_type _count );
+
+            static Container combine(
+                    Operation _operation
+                ,   Container const& _left
+                ,   Container const& _right
+            );
+
+            /*-----------------------------------------------------------------------*/
+
+            Kind kind() const noexcept;
+
+            size_type cardinality() const noexcept;
+
+            bool is_empty() const noexcept;
+
+            // bytes taken by the values
+            size_type memory() const noexcept;
+
+            /*-----------------------------------------------------------------------*/
+
+            bool contains( value_type _value ) const noexcept;
+
+            void insert( value_type _value );
+
+            void remove( value_type _value );
+
+            /*-----------------------------------------------------------------------*/
+
+            // the container as BitmapBlocks blocks
+            void to_blocks( block_type * _blocks ) const noexcept;
+
+            // switches to the smallest of the three forms
+            void optimize();
+
+            // _callback( value ) for every value in increasing order
+            template< typename _Callback >
+            void for_each( _Callback _callback ) const;
+
+        private:
+
+            static Container merge_arrays(
+                    Operation _operation
+                ,   Container const& _left
+                ,   Container const& _right
+            );
+
+            static Container merge_runs(
+                    Operation _operation
+                ,   Container const& _left
+                ,   Container const& _right
+            );
+
+            // the values of the array _values that _other contains, or
+            // does not contain for a difference
+            static Container filter(
+                    Operation _operation
+                ,   Container const& _values
+                ,   Container const& _other
+            );
+
+            static Container combine_bitmaps(
+                    Operation _operation
+                ,   Container const& _left
+                ,   Container const& _right
+            );
+
+            /*-----------------------------------------------------------------------*/
+
+            size_type count_runs() const noexcept;
+
+            void to_array();
+
+            void to_bitmap();
+
+            void to_runs();
+
+            /*-----------------------------------------------------------------------*/
+
+            Kind m_kind;
+
+            size_type m_cardinality;
+
+            std::vector< value_type > m_array;
+
+            std::vector< block_type > m_bitmap;
+
+            std::vector< Run > m_runs;
+
+    }; // class Container
+
+/*-----------------------------------------------------------------------------------*/
+
+    template< typename _Callback >
+    void
+    Container::for_each( _Callback _callback ) const
+    {
+        switch( m_kind )
+        {
+            case Kind::Array:
+                for( value_type value : m_array )
+                    _callback( value );
+                break;
+
+            case Kind::Bitmap:
+                for( size_type index = 0; index < BitmapBlocks; ++index )
+                    for( block_type block = m_bitmap[index]; block; block &= block - 1 )
+                        _callback( static_cast< value_type >(
+                            index * sizeof( block_type ) * 8 + BitKernels::countTrailingZeros( block )
+                        ) );
+                break;
+
+            case Kind::Runs:
+                for( Run const& run : m_runs )
+                    for( size_type value = run.m_first; value <= run.m_last; ++value )
+                        _callback( static_cast< value_type >( value ) );
+                break;
+        }
+    }
+
+/*-----------------------------------------------------------------------------------*/
+
+}; // namespace Roaring
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // ROARING_CONTAINER_HPP_
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,591 @@
+/** (C) 2016 Ivan Semenenko */
+
+#include "roaring_set.hpp"
+#include "messages.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/*-----------------------------------------------------------------------------------*/
+
+namespace {
+
+/*-----------------------------------------------------------------------------------*/
+
+    using Roaring::Container;
+    using Roaring::Operation;
+    using block_type = RoaringSet::block_type;
+    using size_type = RoaringSet::size_type;
+
+    // the chunk of an exhausted source, after every real one
+    constexpr size_type NoChunk = std::numeric_limits< size_type >::max();
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the containers of a RoaringSet
+    class SparseChunks
+    {
+
+        public:
+
+            SparseChunks(
+                    std::vector< size_type > const& _chunks
+                ,   std::vector< Container > const& _containers
+            ) noexcept
+                :    m_chunks( _chunks )
+                ,    m_containers( _containers )
+                ,    m_index{ 0 }
+            {
+            }
+
+            size_type chunk() const noexcept
+            {
+                return m_index < m_chunks.size() ? m_chunks[m_index] : NoChunk;
+            }
+
+            Container const& container() const noexcept
+            {
+                return m_containers[m_index];
+            }
+
+            void next() noexcept
+            {
+                ++m_index;
+            }
+
+            // on to the first chunk not below _chunk
+            void seek( size_type _chunk ) noexcept
+            {
+                m_index = std::lower_bound( m_chunks.begin() + m_index, m_chunks.end(), _chunk )
+                    -   m_chunks.begin();
+            }
+
+        private:
+
+            std::vector< size_type > const& m_chunks;
+
+            std::vector< Container > const& m_containers;
+
+            size_type m_index;
+
+    }; // class SparseChunks
+
+/*-----------------------------------------------------------------------------------*/
+
+    // the blocks of a BinarySet, a container built only for the chunks
+    // that are asked for
+    class DenseChunks
+    {
+
+        public:
+
+            DenseChunks( block_type const* _blocks, size_type _cells ) noexcept
+                :    m_pBlocks{ _blocks }
+                ,    m_cells{ _cells }
+                ,    m_cell{ BitKernels::selected().m_findNonZero( _blocks, _cells ) }
+                ,    m_built{ false }
+            {
+            }
+
+            size_type chunk() const noexcept
+            {
+                return m_cell < m_cells ? m_cell / Roaring::BitmapBlocks : NoChunk;
+            }
+
+            Container const& container()
+            {
+                if( !m_built )
+                {
+                    size_type first = chunk() * Roaring::BitmapBlocks;
+
+                    m_container = Container::from_blocks(
+                            m_pBlocks + first
+                        ,   std::min( Roaring::BitmapBlocks, m_cells - first )
+                    );
+
+                    m_built = true;
+                }
+
+                return m_container;
+            }
+
+            void next() noexcept
+            {
+                seek( chunk() + 1 );
+            }
+
+            void seek( size_type _chunk ) noexcept
+            {
+                if( _chunk > ( m_cells - 1 ) / Roaring::BitmapBlocks )
+                    m_cell = m_cells;
+
+                else if( _chunk * Roaring::BitmapBlocks > m_cell )
+                {
+                    size_type first = _chunk * Roaring::BitmapBlocks;
+
+                    m_cell = first
+                        +   BitKernels::selected().m_findNonZero( m_pBlocks + first, m_cells - first );
+                }
+                else
+                    return;
+
+                m_built = false;
+            }
+
+        private:
+
+            block_type const* m_pBlocks;
+
+            size_type m_cells;
+
+            // the first block not 0 from the current chunk on
+            size_type m_cell;
+
+            Container m_container;
+
+            bool m_built;
+
+    }; // class DenseChunks
+
+/*-----------------------------------------------------------------------------------*/
+
+} // namespace
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::RoaringSet( size_type _size )
+    :    m_size{ _size }
+{
+    checkInitialSize( _size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::RoaringSet( BinarySet const& _set )
+    :    m_size{ _set.size() }
+{
+    for(
+        DenseChunks chunks( get_blocks( _set ), get_cells( _set ) );
+        chunks.chunk() != NoChunk;
+        chunks.next()
+    )
+    {
+        m_chunks.push_back( chunks.chunk() );
+        m_containers.push_back( chunks.container() );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::size() const noexcept
+{
+    return m_size;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+RoaringSet::is_empty() const noexcept
+{
+    // containers left empty are dropped
+    return m_chunks.empty();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::count() const noexcept
+{
+    size_type result = 0;
+
+    for( Container const& container : m_containers )
+        result += container.cardinality();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::memory() const noexcept
+{
+    size_type result = m_chunks.capacity() * sizeof( size_type )
+        +   m_containers.capacity() * sizeof( Container );
+
+    for( Container const& container : m_containers )
+        result += container.memory();
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::clear() noexcept
+{
+    m_chunks.clear();
+    m_containers.clear();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+bool
+RoaringSet::has_key( size_type _index ) const
+{
+    checkKeyRange( _index );
+
+    size_type chunk = get_chunk( _index );
+    size_type position = find_chunk( chunk );
+
+    return position < m_chunks.size()
+        &&  m_chunks[position] == chunk
+        &&  m_containers[position].contains( get_value( _index ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::insert_key( size_type _index )
+{
+    checkKeyRange( _index );
+
+    size_type chunk = get_chunk( _index );
+    size_type position = find_chunk( chunk );
+
+    if( position == m_chunks.size() || m_chunks[position] != chunk )
+    {
+        m_chunks.insert( m_chunks.begin() + position, chunk );
+        m_containers.emplace( m_containers.begin() + position );
+    }
+
+    m_containers[position].insert( get_value( _index ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::remove_key( size_type _index )
+{
+    checkKeyRange( _index );
+
+    size_type chunk = get_chunk( _index );
+    size_type position = find_chunk( chunk );
+
+    if( position == m_chunks.size() || m_chunks[position] != chunk )
+        return;
+
+    m_containers[position].remove( get_value( _index ) );
+
+    if( m_containers[position].is_empty() )
+    {
+        m_chunks.erase( m_chunks.begin() + position );
+        m_containers.erase( m_containers.begin() + position );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::flip_key( size_type _index )
+{
+    if( has_key( _index ) )
+        remove_key( _index );
+    else
+        insert_key( _index );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::optimize()
+{
+    for( Container & container : m_containers )
+        container.optimize();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+BinarySet
+RoaringSet::to_binary_set() const
+{
+    BinarySet result( m_size );
+
+    block_type* blocks = result.m_pBitVector;
+    size_type cells = get_cells( result );
+
+    std::vector< block_type > scratch;
+
+    for( size_type index = 0; index < m_chunks.size(); ++index )
+    {
+        size_type first = m_chunks[index] * Roaring::BitmapBlocks;
+
+        // the last chunk may be cut short by the set size
+        if( cells - first >= Roaring::BitmapBlocks )
+            m_containers[index].to_blocks( blocks + first );
+        else
+        {
+            scratch.resize( Roaring::BitmapBlocks );
+            m_containers[index].to_blocks( scratch.data() );
+
+            std::copy( scratch.begin(), scratch.begin() + ( cells - first ), blocks + first );
+        }
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::get_chunk( size_type _index ) noexcept
+{
+    return ( _index - 1 ) >> Roaring::ChunkBits;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+Roaring::value_type
+RoaringSet::get_value( size_type _index ) noexcept
+{
+    return static_cast< Roaring::value_type >( _index - 1 );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::find_chunk( size_type _chunk ) const noexcept
+{
+    return std::lower_bound( m_chunks.begin(), m_chunks.end(), _chunk ) - m_chunks.begin();
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _LeftChunks, typename _RightChunks >
+RoaringSet
+RoaringSet::combine(
+        Operation _operation
+    ,   _LeftChunks & _left
+    ,   _RightChunks & _right
+    ,   size_type _size
+)
+{
+    // whether chunks found on one side only are kept as they are, or
+    // skipped past without being looked at
+    bool const keepsLeft = _operation != Operation::Intersect;
+    bool const keepsRight = _operation == Operation::Unite || _operation == Operation::SymmDiff;
+
+    RoaringSet result( _size );
+
+    for( ;; )
+    {
+        size_type leftChunk = _left.chunk();
+        size_type rightChunk = _right.chunk();
+
+        if( leftChunk == NoChunk && rightChunk == NoChunk )
+            break;
+
+        if( leftChunk == rightChunk )
+        {
+            Container container = Container::combine( _operation, _left.container(), _right.container() );
+
+            if( !container.is_empty() )
+            {
+                result.m_chunks.push_back( leftChunk );
+                result.m_containers.push_back( std::move( container ) );
+            }
+
+            _left.next();
+            _right.next();
+        }
+        else if( leftChunk < rightChunk )
+        {
+            if( !keepsLeft )
+            {
+                _left.seek( rightChunk );
+                continue;
+            }
+
+            result.m_chunks.push_back( leftChunk );
+            result.m_containers.push_back( _left.container() );
+
+            _left.next();
+        }
+        else
+        {
+            if( !keepsRight )
+            {
+                _right.seek( leftChunk );
+                continue;
+            }
+
+            result.m_chunks.push_back( rightChunk );
+            result.m_containers.push_back( _right.container() );
+
+            _right.next();
+        }
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::block_type const*
+RoaringSet::get_blocks( BinarySet const& _set ) noexcept
+{
+    return _set.m_pBitVector;
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet::size_type
+RoaringSet::get_cells( BinarySet const& _set ) noexcept
+{
+    return _set.get_cell( _set.m_size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::checkKeyRange( size_type _index ) const
+{
+    if( _index < 1 || _index > m_size )
+        throw std::logic_error( Messages::OutOfRange );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+void
+RoaringSet::checkInitialSize( size_type _size ) const
+{
+    if( _size < 1 )
+        throw std::logic_error( Messages::InvalidSize );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetUnite( RoaringSet const& _left, RoaringSet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    SparseChunks right( _right.m_chunks, _right.m_containers );
+
+    return RoaringSet::combine( Operation::Unite, left, right, std::max( _left.m_size, _right.m_size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetUnite( RoaringSet const& _left, BinarySet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    DenseChunks right( RoaringSet::get_blocks( _right ), RoaringSet::get_cells( _right ) );
+
+    return RoaringSet::combine( Operation::Unite, left, right, std::max( _left.m_size, _right.size() ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetUnite( BinarySet const& _left, RoaringSet const& _right )
+{
+    return RoaringSetUnite( _right, _left );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetIntersect( RoaringSet const& _left, RoaringSet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    SparseChunks right( _right.m_chunks, _right.m_containers );
+
+    return RoaringSet::combine( Operation::Intersect, left, right, std::min( _left.m_size, _right.m_size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetIntersect( RoaringSet const& _left, BinarySet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    DenseChunks right( RoaringSet::get_blocks( _right ), RoaringSet::get_cells( _right ) );
+
+    return RoaringSet::combine( Operation::Intersect, left, right, std::min( _left.m_size, _right.size() ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetIntersect( BinarySet const& _left, RoaringSet const& _right )
+{
+    return RoaringSetIntersect( _right, _left );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetDifference( RoaringSet const& _left, RoaringSet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    SparseChunks right( _right.m_chunks, _right.m_containers );
+
+    return RoaringSet::combine( Operation::Difference, left, right, _left.m_size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetDifference( RoaringSet const& _left, BinarySet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    DenseChunks right( RoaringSet::get_blocks( _right ), RoaringSet::get_cells( _right ) );
+
+    return RoaringSet::combine( Operation::Difference, left, right, _left.m_size );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetDifference( BinarySet const& _left, RoaringSet const& _right )
+{
+    DenseChunks left( RoaringSet::get_blocks( _left ), RoaringSet::get_cells( _left ) );
+    SparseChunks right( _right.m_chunks, _right.m_containers );
+
+    return RoaringSet::combine( Operation::Difference, left, right, _left.size() );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetSymmDiff( RoaringSet const& _left, RoaringSet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    SparseChunks right( _right.m_chunks, _right.m_containers );
+
+    return RoaringSet::combine( Operation::SymmDiff, left, right, std::max( _left.m_size, _right.m_size ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetSymmDiff( RoaringSet const& _left, BinarySet const& _right )
+{
+    SparseChunks left( _left.m_chunks, _left.m_containers );
+    DenseChunks right( RoaringSet::get_blocks( _right ), RoaringSet::get_cells( _right ) );
+
+    return RoaringSet::combine( Operation::SymmDiff, left, right, std::max( _left.m_size, _right.size() ) );
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+RoaringSet
+RoaringSetSymmDiff( BinarySet const& _left, RoaringSet const& _right )
+{
+    return RoaringSetSymmDiff( _right, _left );
+}
+
+/*-----------------------------------------------------------------------------------*/
@@ -0,0 +1,167 @@
+/** (C) 2016 Ivan Semenenko */
+
+#ifndef ROARING_SET_HPP_
+#define ROARING_SET_HPP_
+
+/*-----------------------------------------------------------------------------------*/
+
+#include "binary_set.hpp"
+#include "roaring_container.hpp"
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------*/
+
+/*
+*  A compressed BinarySet for sparse or clustered keys. The keys are split
+*  into chunks of 65536, and only the chunks holding keys are kept, each
+*  as a Roaring::Container in whichever form is the smallest.
+*
+*  The set operations work container by container across the forms, and
+*  accept a dense BinarySet on either side: its blocks are read chunk by
+*  chunk, skipping the empty ones, without converting the whole set. The
+*  result sizes follow BinarySet.
+*/
+
+class RoaringSet
+{
+
+    public:
+
+        /*---------------------------------------------------------------------------*/
+
+        using block_type = BinarySet::block_type;
+        using size_type = BinarySet::size_type;
+
+        /*---------------------------------------------------------------------------*/
+
+        explicit RoaringSet( size_type _size );
+
+        explicit RoaringSet( BinarySet const& _set );
+
+        /*---------------------------------------------------------------------------*/
+
+        size_type size() const noexcept;
+
+        bool is_empty() const noexcept;
+
+        // number of keys in the set
+        size_type count() const noexcept;
+
+        // bytes taken by the containers and their directory
+        size_type memory() const noexcept;
+
+        void clear() noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        bool has_key( size_type _index ) const;
+
+        void insert_key( size_type _index );
+
+        void remove_key( size_type _index );
+
+        void flip_key( size_type _index );
+
+        /*---------------------------------------------------------------------------*/
+
+        // switches every container to its smallest form, worth calling
+        // after many single insertions or removals
+        void optimize();
+
+        BinarySet to_binary_set() const;
+
+        // _callback( key ) for every key in increasing order
+        template< typename _Callback >
+        void for_each_key( _Callback _callback ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        friend RoaringSet RoaringSetUnite( RoaringSet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetUnite( RoaringSet const& _left, BinarySet const& _right );
+
+        friend RoaringSet RoaringSetUnite( BinarySet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetIntersect( RoaringSet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetIntersect( RoaringSet const& _left, BinarySet const& _right );
+
+        friend RoaringSet RoaringSetIntersect( BinarySet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetDifference( RoaringSet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetDifference( RoaringSet const& _left, BinarySet const& _right );
+
+        friend RoaringSet RoaringSetDifference( BinarySet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetSymmDiff( RoaringSet const& _left, RoaringSet const& _right );
+
+        friend RoaringSet RoaringSetSymmDiff( RoaringSet const& _left, BinarySet const& _right );
+
+        friend RoaringSet RoaringSetSymmDiff( BinarySet const& _left, RoaringSet const& _right );
+
+    private:
+
+        // chunk of a key and the key's value inside it
+        static size_type get_chunk( size_type _index ) noexcept;
+
+        static Roaring::value_type get_value( size_type _index ) noexcept;
+
+        // position of _chunk in m_chunks, or of the first chunk after it
+        size_type find_chunk( size_type _chunk ) const noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        // chunk by chunk over two sources, each either a RoaringSet or
+        // the blocks of a BinarySet
+        template< typename _LeftChunks, typename _RightChunks >
+        static RoaringSet combine(
+                Roaring::Operation _operation
+            ,   _LeftChunks & _left
+            ,   _RightChunks & _right
+            ,   size_type _size
+        );
+
+        static block_type const* get_blocks( BinarySet const& _set ) noexcept;
+
+        static size_type get_cells( BinarySet const& _set ) noexcept;
+
+        /*---------------------------------------------------------------------------*/
+
+        inline void checkKeyRange( size_type _index ) const;
+
+        inline void checkInitialSize( size_type _size ) const;
+
+        /*---------------------------------------------------------------------------*/
+
+        // the chunks holding keys in increasing order, and their containers
+        std::vector< size_type > m_chunks;
+
+        std::vector< Roaring::Container > m_containers;
+
+        size_type m_size;
+
+}; // class RoaringSet
+
+/*-----------------------------------------------------------------------------------*/
+
+template< typename _Callback >
+void
+RoaringSet::for_each_key( _Callback _callback ) const
+{
+    for( size_type index = 0; index < m_chunks.size(); ++index )
+    {
+        size_type base = ( m_chunks[index] << Roaring::ChunkBits ) + 1;
+
+        m_containers[index].for_each(
+            [&]( Roaring::value_type _value ){ _callback( base + _value ); }
+        );
+    }
+}
+
+/*-----------------------------------------------------------------------------------*/
+
+#endif // ROARING_SET_HPP_
+
+/*-----------------------------------------------------------------------------------*/